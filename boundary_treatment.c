@@ -14,6 +14,7 @@
 #include "boundary_treatment.h"
 #include <stdio.h> /* standard library for input and output */
 #include "immersed_boundary.h"
+#include "data_exchange.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -50,6 +51,9 @@ void TreatBoundary(const int tn, Space *space, const Model *model)
     int box[DIMS][LIMIT] = {{0}}; /* range box of numerical boundary */
     for (int r = 0; r <= R; ++r) { /* process layer by layer */
         for (int p = PWB; p <= PBB; ++p) {
+            if (NONE != part->nb[p]) { /* shared with a neighbouring block */
+                continue;
+            }
             const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
             for (int s = 0; s < DIMS; ++s) { /* compute range box of each layer */
                 box[s][MIN] = part->ns[p][s][MIN] + MinInt(r, ng[s]) * (N[s] - !N[s]);
@@ -61,6 +65,12 @@ void TreatBoundary(const int tn, Space *space, const Model *model)
             ApplyBoundaryCondition(p, r, box, tn, space, model);
         }
     }
+    /*
+     * Block boundary treatment
+     * Ghost layers shared with neighbouring blocks are filled at last,
+     * which also overwrites the corner ghost nodes treated above.
+     */
+    ExchangeFieldData(tn, space);
     return;
 }
 static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][LIMIT],
@@ -78,10 +88,10 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
         part->varBC[p][5]};
     const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
     const IntVec LN = {part->m[X] * N[X], part->m[Y] * N[Y], part->m[Z] * N[Z]};
-    Real *restrict UG = NULL;
-    Real *restrict UI = NULL;
-    Real *restrict UO = NULL;
-    Real *restrict Uh = NULL;
+    Real UG[DIMU] = {zero};
+    Real UI[DIMU] = {zero};
+    Real UO[DIMU] = {zero};
+    Real Uh[DIMU] = {zero};
     int idxG = 0; /* index at ghost node */
     int idxI = 0; /* index at image node */
     int idxO = 0; /* index at boundary point */
@@ -100,16 +110,15 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                  */
                 if (0 != r) { /* treat ghost layers */
                     idxG = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    UG = node[idxG].U[tn];
                     switch (part->typeBC[p]) {
                         case SLIPWALL:
                             /* fall through */
                         case NOSLIPWALL:
                             idxO = IndexNode(k - r*N[Z], j - r*N[Y], i - r*N[X], part->n[Y], part->n[X]);
-                            UO = node[idxO].U[tn];
+                            LoadU(tn, idxO, node, UO);
                             MapPrimitive(model->gamma, model->gasR, UO, UoO);
                             idxI = IndexNode(k - 2*r*N[Z], j - 2*r*N[Y], i - 2*r*N[X], part->n[Y], part->n[X]);
-                            UI = node[idxI].U[tn];
+                            LoadU(tn, idxI, node, UI);
                             MapPrimitive(model->gamma, model->gasR, UI, UoI);
                             DoMethodOfImage(UoI, UoO, UoG);
                             UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
@@ -117,19 +126,20 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                             break;
                         case PERIODIC:
                             idxh = IndexNode(k - LN[Z], j - LN[Y], i - LN[X], part->n[Y], part->n[X]);
-                            Uh = node[idxh].U[tn];
+                            LoadU(tn, idxh, node, Uh);
                             EnforceZeroGradient(Uh, UG);
                             break;
                         default:
                             idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                            Uh = node[idxh].U[tn];
+                            LoadU(tn, idxh, node, Uh);
                             EnforceZeroGradient(Uh, UG);
                             break;
                     }
+                    StoreU(tn, idxG, UG, node);
                     continue;
                 }
                 idxO = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                UO = node[idxO].U[tn];
+                LoadU(tn, idxO, node, UO);
                 switch (part->typeBC[p]) { /* treat physical boundary */
                     case INFLOW:
                         MapConservative(model->gamma, UoGiven, UO);
@@ -137,12 +147,12 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                     case OUTFLOW:
                         /* Calculate inner neighbour nodes according to normal vector direction. */
                         idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
+                        LoadU(tn, idxh, node, Uh);
                         EnforceZeroGradient(Uh, UO);
                         break;
                     case SLIPWALL: /* zero-gradient for scalar and tangential component, zero for normal component */
                         idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
+                        LoadU(tn, idxh, node, Uh);
                         MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
                         UoO[1] = (!N[X]) * Uoh[1];
                         UoO[2] = (!N[Y]) * Uoh[2];
@@ -158,7 +168,7 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                         break;
                     case NOSLIPWALL:
                         idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
+                        LoadU(tn, idxh, node, Uh);
                         MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
                         UoO[1] = zero;
                         UoO[2] = zero;
@@ -178,6 +188,7 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                     default:
                         break;
                 }
+                StoreU(tn, idxO, UO, node);
             }
         }
     }
@@ -68,20 +68,26 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "0                  # maximum computing steps (int; 0: auto)\n");
     fprintf(fp, "1                  # space data writing frequency (int; 0: inf)\n");
     fprintf(fp, "1                  # data streamer (int; 0: ParaView; 1: Ensight)\n");
+    fprintf(fp, "0                  # data format (int; 0: ascii; 1: binary; 2: base64)\n");
     fprintf(fp, "time end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "checkpoint begin\n");
+    fprintf(fp, "0                  # checkpoint interval (int, space data exports; 0: off)\n");
+    fprintf(fp, "checkpoint end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Numerical Method <<\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "numerical begin\n");
-    fprintf(fp, "1                  # temporal scheme (int; 0: RK2; 1: RK3;)\n");
+    fprintf(fp, "1                  # temporal scheme (int; 0: RK2; 1: RK3; 2: LSRK3; 3: LSRK4)\n");
     fprintf(fp, "1                  # spatial scheme (int; 0: WENO3; 1: WENO5;)\n");
     fprintf(fp, "0                  # dimension scheme (int; 0: dim split; 1: dim by dim)\n");
     fprintf(fp, "0                  # Jacobian average (int; 0: Arithmetic; 1: Roe)\n");
     fprintf(fp, "0                  # flux splitting method (int; 0: LLF; 1: SW)\n");
-    fprintf(fp, "0                  # phase interaction (int; 0: F; 1: FSI; 2: FSI+SSI)\n");
+    fprintf(fp, "0                  # phase interaction (int; 0: F; 1: FSI; 2: FSI+SSI; 3: FSI+DEM)\n");
     fprintf(fp, "1                  # ibm reconstruction layers (int; 0: inf)\n");
+    fprintf(fp, "0                  # node mapping (int; 0: closest face; 1: scanline; 2: swept band)\n");
     fprintf(fp, "numerical end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
@@ -93,6 +99,7 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "0                  # viscous level (0: none; 1: normal)\n");
     fprintf(fp, "0                  # gravity state (int; 0: off; 1: on)\n");
     fprintf(fp, "0, -9.806, 0       # gravity vector\n");
+    fprintf(fp, "1.0e4              # contact stiffness (DEM)\n");
     fprintf(fp, "material end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
@@ -252,6 +259,22 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "2.5, 2.2197, 0     # x2, y2, z2\n");
     fprintf(fp, "500                # resolution\n");
     fprintf(fp, "line probe end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "slice probe begin\n");
+    fprintf(fp, "0                  # slice probe count (int; 0: off)\n");
+    fprintf(fp, "1                  # slice probe writing frequency (int; 0: inf)\n");
+    fprintf(fp, "2, 0               # normal axis (int; 0: x; 1: y; 2: z), coordinate\n");
+    fprintf(fp, "slice probe end\n");
+    fprintf(fp, "#------------------------------------------------------------------------------\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "#                    >> Field Statistics <<\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "# Running means, RMS values, and Reynolds stresses are written with the\n");
+    fprintf(fp, "# space data as the stats dataset.\n");
+    fprintf(fp, "#------------------------------------------------------------------------------\n");
+    fprintf(fp, "statistics begin\n");
+    fprintf(fp, "0                  # sampling interval (int, steps; 0: off)\n");
+    fprintf(fp, "statistics end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#/* a good practice: end file with a newline */\n");
@@ -33,7 +33,9 @@ void LoadCaseData(Time *time, Space *space, Model *model)
 {
     ReadCaseSettingData(time, space, model);
     ReadGeometrySettingData(&(space->geo));
-    WriteVerifyData(time, space, model);
+    if (0 == space->part.rank) {
+        WriteVerifyData(time, space, model);
+    }
     CheckCaseSettingData(time, space, model);
     return;
 }
@@ -52,6 +54,7 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
     int nentry = 0; /* entry count */
     const char *fmtI = ParseFormat("%lg");
     const char *fmtJ = ParseFormat("%lg, %lg, %lg");
+    const char *fmtK = ParseFormat("%lg, %lg");
     while (NULL != fgets(str, sizeof str, fp)) {
         ParseCommand(str);
         if (0 == strncmp(str, "space begin", sizeof str)) {
@@ -71,6 +74,7 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             Sread(fp, 1, "%d", &(time->stepN));
             Sread(fp, 1, "%d", &(time->dataW[PROSD]));
             Sread(fp, 1, "%d", &(time->dataStreamer));
+            Sread(fp, -1, "%d", &(time->dataFormat)); /* optional, ascii if absent */
             continue;
         }
         if (0 == strncmp(str, "numerical begin", sizeof str)) {
@@ -82,6 +86,7 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             Sread(fp, 1, "%d", &(model->fluxSplit));
             Sread(fp, 1, "%d", &(model->psi));
             Sread(fp, 1, "%d", &(model->ibmLayer));
+            Sread(fp, -1, "%d", &(model->nodeMap)); /* optional, closest face if absent */
             continue;
         }
         if (0 == strncmp(str, "material begin", sizeof str)) {
@@ -90,6 +95,8 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             Sread(fp, 1, fmtI, &(model->refMu));
             Sread(fp, 1, "%d", &(model->gState));
             Sread(fp, 3, fmtJ, &(model->g[X]), &(model->g[Y]), &(model->g[Z]));
+            model->kn = 1.0e4;
+            Sread(fp, -1, fmtI, &(model->kn)); /* optional, 1.0e4 if absent */
             continue;
         }
         if (0 == strncmp(str, "reference begin", sizeof str)) {
@@ -223,6 +230,28 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             }
             continue;
         }
+        if (0 == strncmp(str, "slice probe begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(time->dataN[PROSL]));
+            Sread(fp, 1, "%d", &(time->dataW[PROSL]));
+            if (0 < time->dataN[PROSL]) {
+                time->sp = AssignStorage(time->dataN[PROSL] * sizeof(*time->sp));
+            }
+            for (int n = 0; n < time->dataN[PROSL]; ++n) {
+                Sread(fp, 2, fmtK, time->sp[n] + 0, time->sp[n] + 1);
+            }
+            continue;
+        }
+        if (0 == strncmp(str, "checkpoint begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(time->ckW));
+            continue;
+        }
+        if (0 == strncmp(str, "statistics begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(time->statW));
+            continue;
+        }
     }
     fclose(fp);
     if (12 != nentry) {
@@ -406,6 +435,8 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "maximum computing steps: %d\n", time->stepN);
     fprintf(fp, "space data writing frequency: %d\n", time->dataW[PROSD]);
     fprintf(fp, "data streamer: %d\n", time->dataStreamer);
+    fprintf(fp, "data format: %d\n", time->dataFormat);
+    fprintf(fp, "checkpoint interval: %d\n", time->ckW);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Numerical Method <<\n");
@@ -418,6 +449,7 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "flux splitting method: %d\n", model->fluxSplit);
     fprintf(fp, "phase interaction: %d\n", model->psi);
     fprintf(fp, "ibm reconstruction layers: %d\n", model->ibmLayer);
+    fprintf(fp, "node mapping: %d\n", model->nodeMap);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                       >> Material Properties <<\n");
@@ -427,6 +459,7 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "viscous level: %.6g\n", model->refMu);
     fprintf(fp, "gravity state: %d\n", model->gState);
     fprintf(fp, "gravity vector: %.6g, %.6g, %.6g\n", model->g[X], model->g[Y], model->g[Z]);
+    fprintf(fp, "contact stiffness: %.6g\n", model->kn);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Reference Values  <<\n");
@@ -483,11 +516,13 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "line probe count: %d\n", time->dataN[PROLN]);
     fprintf(fp, "curve probe count: %d\n", time->dataN[PROCV]);
     fprintf(fp, "force probe count: %d\n", time->dataN[PROFC]);
+    fprintf(fp, "slice probe count: %d\n", time->dataN[PROSL]);
     fprintf(fp, "#\n");
     fprintf(fp, "point probe writing frequency: %d\n", time->dataW[PROPT]);
     fprintf(fp, "line probe writing frequency: %d\n", time->dataW[PROLN]);
     fprintf(fp, "body-conformal probe writing frequency: %d\n", time->dataW[PROCV]);
     fprintf(fp, "surface force writing frequency: %d\n", time->dataW[PROFC]);
+    fprintf(fp, "slice probe writing frequency: %d\n", time->dataW[PROSL]);
     fprintf(fp, "#\n");
     for (int n = 0; n < time->dataN[PROPT]; ++n) {
         fprintf(fp, "point probe x, y, z: %.6g, %.6g, %.6g\n",
@@ -501,6 +536,13 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
                 time->lp[n][3], time->lp[n][4], time->lp[n][5]);
         fprintf(fp, "resolution: %.6g\n", time->lp[n][6]);
     }
+    fprintf(fp, "#\n");
+    for (int n = 0; n < time->dataN[PROSL]; ++n) {
+        fprintf(fp, "slice probe normal axis, coordinate: %.6g, %.6g\n",
+                time->sp[n][0], time->sp[n][1]);
+    }
+    fprintf(fp, "#\n");
+    fprintf(fp, "statistics sampling interval: %d\n", time->statW);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fclose(fp);
@@ -526,15 +568,42 @@ static void CheckCaseSettingData(const Time *time, const Space *space, const Mod
     if ((0 > time->restart) || (zero >= time->end) || (zero >= time->numCFL)) {
         ShowError("values in time section should not be negative");
     }
+    if ((0 > time->dataFormat) || (2 < time->dataFormat)) {
+        ShowError("unknown data format: %d", time->dataFormat);
+    }
+    if (0 > time->ckW) {
+        ShowError("checkpoint interval should not be negative");
+    }
+    if (0 > time->statW) {
+        ShowError("statistics sampling interval should not be negative");
+    }
+    for (int n = 0; n < time->dataN[PROSL]; ++n) {
+        if ((X != (int)time->sp[n][0]) && (Y != (int)time->sp[n][0]) && (Z != (int)time->sp[n][0])) {
+            ShowError("unknown slice probe normal axis: %.6g", time->sp[n][0]);
+        }
+    }
     /* numerical method */
     if ((0 > model->tScheme) || (0 > model->sScheme) || (0 > model->multidim) ||
-            (0 > model->jacobMean) || (0 > model->fluxSplit) || (0 > model->psi)) {
+            (0 > model->jacobMean) || (0 > model->fluxSplit) || (0 > model->psi) ||
+            (0 > model->nodeMap)) {
         ShowError("values in numerical section should not be negative");
     }
+    if (LSRKFOUR < model->tScheme) {
+        ShowError("unknown temporal scheme: %d", model->tScheme);
+    }
+    if (3 < model->psi) {
+        ShowError("unknown phase interaction: %d", model->psi);
+    }
+    if (2 < model->nodeMap) {
+        ShowError("unknown node mapping: %d", model->nodeMap);
+    }
     /* material */
     if ((0 > model->mid)) {
         ShowError("material type should not be negative");
     }
+    if ((3 == model->psi) && (zero >= model->kn)) {
+        ShowError("contact stiffness should be positive");
+    }
     /* reference */
     if ((zero >= model->refL) || (zero >= model->refRho) ||
             (zero >= model->refV) || (zero >= model->refT)) {
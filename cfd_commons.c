@@ -244,6 +244,191 @@ static void EigenvectorRZ(const Real u, const Real v, const Real w, const Real h
     R[4][0] = hT - w * c;  R[4][1] = u;    R[4][2] = v;    R[4][3] = w * w - q;  R[4][4] = hT + w * c;
     return;
 }
+/*
+ * In the batched functions the interface loop is the innermost one and is
+ * kept free of branches so that it vectorizes. Square roots are taken in a
+ * separate loop since their errno handling blocks vectorization.
+ */
+void SymmetricAverageBatch(const int averager, const Real gamma,
+        Real UL[restrict][BATCHN], Real UR[restrict][BATCHN], Real Uo[restrict][BATCHN])
+{
+    Real hTL[BATCHN], hTR[BATCHN]; /* total enthalpy */
+    Real D[BATCHN]; /* Roe average weight */
+    for (int b = 0; b < BATCHN; ++b) {
+        hTL[b] = (UL[4][b] / UL[0][b]) * gamma - 0.5 * ((UL[1][b] / UL[0][b]) * (UL[1][b] / UL[0][b]) +
+                (UL[2][b] / UL[0][b]) * (UL[2][b] / UL[0][b]) + (UL[3][b] / UL[0][b]) * (UL[3][b] / UL[0][b])) *
+            (gamma - 1.0);
+        hTR[b] = (UR[4][b] / UR[0][b]) * gamma - 0.5 * ((UR[1][b] / UR[0][b]) * (UR[1][b] / UR[0][b]) +
+                (UR[2][b] / UR[0][b]) * (UR[2][b] / UR[0][b]) + (UR[3][b] / UR[0][b]) * (UR[3][b] / UR[0][b])) *
+            (gamma - 1.0);
+    }
+    switch (averager) {
+        case 0: /* arithmetic mean */
+            for (int r = 1; r < 4; ++r) {
+                for (int b = 0; b < BATCHN; ++b) {
+                    Uo[r][b] = 0.5 * (UL[r][b] / UL[0][b] + UR[r][b] / UR[0][b]);
+                }
+            }
+            for (int b = 0; b < BATCHN; ++b) {
+                Uo[4][b] = 0.5 * (hTL[b] + hTR[b]);
+            }
+            break;
+        case 1: /* Roe average */
+            for (int b = 0; b < BATCHN; ++b) {
+                D[b] = sqrt(UR[0][b] / UL[0][b]);
+            }
+            for (int r = 1; r < 4; ++r) {
+                for (int b = 0; b < BATCHN; ++b) {
+                    Uo[r][b] = (UL[r][b] / UL[0][b] + D[b] * (UR[r][b] / UR[0][b])) / (1.0 + D[b]);
+                }
+            }
+            for (int b = 0; b < BATCHN; ++b) {
+                Uo[4][b] = (hTL[b] + D[b] * hTR[b]) / (1.0 + D[b]);
+            }
+            break;
+        default:
+            break;
+    }
+    for (int b = 0; b < BATCHN; ++b) {
+        Uo[5][b] = (gamma - 1.0) * (Uo[4][b] - 0.5 * (Uo[1][b] * Uo[1][b] + Uo[2][b] * Uo[2][b] + Uo[3][b] * Uo[3][b]));
+    }
+    for (int b = 0; b < BATCHN; ++b) {
+        Uo[5][b] = sqrt(Uo[5][b]); /* the speed of sound */
+    }
+    return;
+}
+void EigenvalueSplittingBatch(const int s, const int splitter,
+        Real Uo[restrict][BATCHN], Real LambdaP[restrict][BATCHN], Real LambdaN[restrict][BATCHN])
+{
+    const Real epsilon = 1.0e-3;
+    Real Lambda[DIMU][BATCHN]; /* eigenvalues */
+    Real lambdaStar[BATCHN]; /* local maximum */
+    for (int b = 0; b < BATCHN; ++b) {
+        Lambda[0][b] = Uo[s+1][b] - Uo[5][b];
+        Lambda[1][b] = Uo[s+1][b];
+        Lambda[2][b] = Uo[s+1][b];
+        Lambda[3][b] = Uo[s+1][b];
+        Lambda[4][b] = Uo[s+1][b] + Uo[5][b];
+    }
+    switch (splitter) {
+        case 0: /* local Lax-Friedrichs */
+            for (int b = 0; b < BATCHN; ++b) {
+                lambdaStar[b] = fabs(Lambda[2][b]) + Lambda[4][b] - Lambda[2][b];
+            }
+            for (int r = 0; r < DIMU; ++r) {
+                for (int b = 0; b < BATCHN; ++b) {
+                    LambdaP[r][b] = 0.5 * (Lambda[r][b] + lambdaStar[b]);
+                    LambdaN[r][b] = 0.5 * (Lambda[r][b] - lambdaStar[b]);
+                }
+            }
+            break;
+        case 1: /* Steger-Warming */
+            for (int r = 0; r < DIMU; ++r) {
+                for (int b = 0; b < BATCHN; ++b) {
+                    lambdaStar[b] = sqrt(Lambda[r][b] * Lambda[r][b] + epsilon * epsilon);
+                }
+                for (int b = 0; b < BATCHN; ++b) {
+                    LambdaP[r][b] = 0.5 * (Lambda[r][b] + lambdaStar[b]);
+                    LambdaN[r][b] = 0.5 * (Lambda[r][b] - lambdaStar[b]);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    return;
+}
+/*
+ * The eigenvectors of the three directions only differ by which velocity
+ * component is normal to the interface. Writing them in terms of the normal
+ * component n gives a single loop nest for all directions. The product order
+ * of each entry follows EigenvectorLX, LY, and LZ.
+ */
+void EigenvectorLBatch(const int s, const Real gamma,
+        Real Uo[restrict][BATCHN], Real L[restrict][DIMU][BATCHN])
+{
+    const int n = s + 1; /* normal velocity component */
+    Real q[BATCHN], bb[BATCHN], d[BATCHN];
+    for (int b = 0; b < BATCHN; ++b) {
+        q[b] = 0.5 * (Uo[1][b] * Uo[1][b] + Uo[2][b] * Uo[2][b] + Uo[3][b] * Uo[3][b]);
+        bb[b] = (gamma - 1.0) / (2.0 * Uo[5][b] * Uo[5][b]);
+        d[b] = 1.0 / (2.0 * Uo[5][b]);
+        L[0][0][b] = bb[b] * q[b] + d[b] * Uo[n][b];
+        L[4][0][b] = bb[b] * q[b] - d[b] * Uo[n][b];
+        L[0][4][b] = bb[b];
+        L[4][4][b] = bb[b];
+    }
+    for (int c = 1; c < 4; ++c) {
+        for (int b = 0; b < BATCHN; ++b) {
+            L[0][c][b] = -bb[b] * Uo[c][b];
+            L[4][c][b] = -bb[b] * Uo[c][b];
+        }
+    }
+    for (int b = 0; b < BATCHN; ++b) {
+        L[0][n][b] = L[0][n][b] - d[b];
+        L[4][n][b] = L[4][n][b] + d[b];
+    }
+    for (int t = 1; t < 4; ++t) {
+        if (n == t) {
+            for (int b = 0; b < BATCHN; ++b) {
+                L[t][0][b] = -2.0 * bb[b] * q[b] + 1.0;
+                L[t][4][b] = -2.0 * bb[b];
+            }
+            for (int c = 1; c < 4; ++c) {
+                for (int b = 0; b < BATCHN; ++b) {
+                    L[t][c][b] = 2.0 * bb[b] * Uo[c][b];
+                }
+            }
+            continue;
+        }
+        for (int b = 0; b < BATCHN; ++b) {
+            L[t][0][b] = -2.0 * bb[b] * q[b] * Uo[t][b];
+            L[t][4][b] = -2.0 * bb[b] * Uo[t][b];
+        }
+        for (int c = 1; c < 4; ++c) {
+            const int hi = MaxInt(t, c);
+            const int lo = MinInt(t, c);
+            for (int b = 0; b < BATCHN; ++b) {
+                L[t][c][b] = 2.0 * bb[b] * Uo[hi][b] * Uo[lo][b];
+            }
+        }
+        for (int b = 0; b < BATCHN; ++b) {
+            L[t][t][b] = L[t][t][b] + 1.0;
+        }
+    }
+    return;
+}
+void EigenvectorRBatch(const int s,
+        Real Uo[restrict][BATCHN], Real R[restrict][DIMU][BATCHN])
+{
+    const int n = s + 1; /* normal velocity component */
+    for (int t = 1; t < 4; ++t) {
+        for (int b = 0; b < BATCHN; ++b) {
+            R[t][0][b] = Uo[t][b];
+            R[t][4][b] = Uo[t][b];
+            R[0][t][b] = 0.0;
+            R[4][t][b] = Uo[t][b];
+        }
+        for (int r = 1; r < 4; ++r) {
+            for (int b = 0; b < BATCHN; ++b) {
+                R[r][t][b] = (r == t) ? 1.0 : 0.0;
+            }
+        }
+    }
+    for (int b = 0; b < BATCHN; ++b) {
+        const Real q = 0.5 * (Uo[1][b] * Uo[1][b] + Uo[2][b] * Uo[2][b] + Uo[3][b] * Uo[3][b]);
+        R[0][0][b] = 1.0;
+        R[0][4][b] = 1.0;
+        R[n][0][b] = Uo[n][b] - Uo[5][b];
+        R[n][4][b] = Uo[n][b] + Uo[5][b];
+        R[4][0][b] = Uo[4][b] - Uo[n][b] * Uo[5][b];
+        R[4][4][b] = Uo[4][b] + Uo[n][b] * Uo[5][b];
+        R[0][n][b] = 1.0;
+        R[n][n][b] = Uo[n][b];
+        R[4][n][b] = Uo[n][b] * Uo[n][b] - q;
+    }
+    return;
+}
 void ConvectiveFlux(const int s, const Real gamma, const Real U[restrict], Real F[restrict])
 {
     const Real rho = U[0];
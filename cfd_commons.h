@@ -43,6 +43,22 @@ extern void EigenvalueSplitting(const int splitter, const Real Lambda[restrict],
 extern void EigenvectorL(const int s, const Real gamma, const Real Uo[restrict],
         Real L[restrict][DIMU]);
 extern void EigenvectorR(const int s, const Real Uo[restrict], Real R[restrict][DIMU]);
+/*
+ * Batched average, eigenvalues, and eigenvectors
+ *
+ * Function
+ *      Batched counterparts of the functions above for BATCHN interfaces.
+ *      The interface is the fastest index of all batched arrays, and each
+ *      interface gets the same arithmetic as the scalar functions.
+ */
+extern void SymmetricAverageBatch(const int averager, const Real gamma,
+        Real UL[restrict][BATCHN], Real UR[restrict][BATCHN], Real Uo[restrict][BATCHN]);
+extern void EigenvalueSplittingBatch(const int s, const int splitter,
+        Real Uo[restrict][BATCHN], Real LambdaP[restrict][BATCHN], Real LambdaN[restrict][BATCHN]);
+extern void EigenvectorLBatch(const int s, const Real gamma,
+        Real Uo[restrict][BATCHN], Real L[restrict][DIMU][BATCHN]);
+extern void EigenvectorRBatch(const int s,
+        Real Uo[restrict][BATCHN], Real R[restrict][DIMU][BATCHN]);
 /*
  * Convective fluxes
  *
@@ -78,6 +94,29 @@ extern void MapConservative(const Real gamma, const Real Uo[restrict], Real U[re
  *      Calculate the node index.
  */
 extern int IndexNode(const int k, const int j, const int i, const int jMax, const int iMax);
+/*
+ * Field data access
+ *
+ * Function
+ *      Gather the conservative vector of a node at time level tn from the
+ *      field arrays into a local vector, or scatter it back.
+ *      They are called per node in every hot loop, hence they are defined
+ *      here to be inlined instead of paying a call per node.
+ */
+static inline void LoadU(const int tn, const int idx, const Node *const node, Real U[restrict])
+{
+    for (int n = 0; n < DIMU; ++n) {
+        U[n] = node->U[tn][n][idx];
+    }
+    return;
+}
+static inline void StoreU(const int tn, const int idx, const Real U[restrict], Node *const node)
+{
+    for (int n = 0; n < DIMU; ++n) {
+        node->U[tn][n][idx] = U[n];
+    }
+    return;
+}
 /*
  * Verify node region
  *
@@ -113,6 +113,21 @@ static void SetNodeNumber(Space *space, Model *model)
             part->ng[s] = part->gl;
         }
     }
+    /*
+     * Adjust for block decomposition. The ghost layers shared with a
+     * neighbouring block are normal node layers of the neighbour, which
+     * should cover the stencils of the immersed boundary reconstruction:
+     * an image point can be gl nodes away from its ghost node, and the
+     * reconstruction searches a further R nodes around the image point.
+     */
+    for (int s = 0; s < DIMS; ++s) {
+        if (1 < part->proc[s]) {
+            if (0 == part->ng[s]) {
+                ShowError("decomposing a collapsed dimension: %d\n", s);
+            }
+            part->ng[s] = 2 * part->gl;
+        }
+    }
     /* mesh and node number on each spatial dimension */
     for (int s = 0; s < DIMS; ++s) {
         /* ensure at least two inner cells per dimension */
@@ -171,6 +186,7 @@ static void InitializeParameters(Time *time, Space *space, Model *model)
         model->g[s] = model->g[s] * model->refL / (model->refV * model->refV);
     }
     model->sState = model->gState; /* source state on if gravity on */
+    model->kn = model->kn / (model->refRho * model->refV * model->refV * model->refL);
     /* reference Mach number */
     model->refMa = model->refV / sqrt(model->gamma * model->gasR * model->refT);
     /* reference dynamic viscosity for viscosity normalization */
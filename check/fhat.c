@@ -0,0 +1,127 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
+#include <math.h> /* common mathematical functions */
+#include "../convective_flux.h"
+#include "../cfd_commons.h"
+#include "../commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    NODEN = 128, /* nodes of the test line */
+    LINEN = 101, /* interfaces of a line, not a multiple of the batch size */
+} FhatCheckConst;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void InitializeLine(const Real, Node *);
+/****************************************************************************
+ * The Main Function
+ ****************************************************************************/
+/*
+ * Compare the convective flux of a line, ComputeFhatLine, with the per
+ * interface reference, ComputeFhat, on the same state for every spatial
+ * scheme, Jacobian average, flux splitting, and direction. The state is a
+ * smooth wave with a contact and a shock in it. Exit with failure if any
+ * flux differs by more than the tolerance relative to the flux magnitude.
+ */
+int main(void)
+{
+    const Real tol = 1.0e-12; /* relative tolerance */
+    const int stride[DIMS] = {1, 1, 1}; /* every direction runs along the line */
+    const int idx = 3; /* first interface, leaving room for the widest stencil */
+    Model model = {.gamma = 1.4};
+    Node node = {.levelN = 1};
+    Real (*Fhat)[DIMU] = AssignStorage(LINEN * sizeof(*Fhat));
+    Real F[DIMU] = {0.0};
+    Real err = 0.0; /* largest relative difference */
+    Real fMax = 0.0; /* flux magnitude */
+    int fail = 0;
+    for (int r = 0; r < DIMU; ++r) {
+        node.U[TO][r] = AssignStorage(NODEN * sizeof(*node.U[TO][r]));
+    }
+    InitializeLine(model.gamma, &node);
+    for (int sScheme = WENOTHREE; sScheme <= WENOFIVE; ++sScheme) {
+        model.sScheme = sScheme;
+        model.sL = (WENOTHREE == sScheme) ? -1 : -2;
+        model.sR = (WENOTHREE == sScheme) ? 2 : 3;
+        for (int jacobMean = 0; jacobMean < 2; ++jacobMean) {
+            model.jacobMean = jacobMean;
+            for (int fluxSplit = 0; fluxSplit < 2; ++fluxSplit) {
+                model.fluxSplit = fluxSplit;
+                for (int s = 0; s < DIMS; ++s) {
+                    ComputeFhatLine(TO, s, idx, LINEN, stride, &node, &model, Fhat);
+                    err = 0.0;
+                    fMax = 0.0;
+                    for (int m = 0; m < LINEN; ++m) {
+                        ComputeFhat(TO, s, idx + m, stride, &node, &model, F);
+                        for (int r = 0; r < DIMU; ++r) {
+                            fMax = MaxReal(fMax, fabs(F[r]));
+                        }
+                        for (int r = 0; r < DIMU; ++r) {
+                            err = MaxReal(err, fabs(Fhat[m][r] - F[r]));
+                        }
+                    }
+                    err = err / fMax;
+                    printf("scheme %d, mean %d, split %d, direction %d: %.3g\n",
+                            sScheme, jacobMean, fluxSplit, s, err);
+                    if (tol < err) {
+                        fail = 1;
+                    }
+                }
+            }
+        }
+    }
+    for (int r = 0; r < DIMU; ++r) {
+        RetrieveStorage(node.U[TO][r]);
+    }
+    RetrieveStorage(Fhat);
+    if (fail) {
+        fprintf(stderr, "batched convective flux differs from the scalar one by more than %g\n", tol);
+        exit(EXIT_FAILURE);
+    }
+    exit(EXIT_SUCCESS);
+}
+/*
+ * Smooth density, velocity and pressure waves, with a contact and a shock
+ * of pressure ratio 10 in the line.
+ */
+static void InitializeLine(const Real gamma, Node *node)
+{
+    Real rho = 0.0, u = 0.0, v = 0.0, w = 0.0, p = 0.0;
+    for (int n = 0; n < NODEN; ++n) {
+        rho = 1.0 + 0.3 * sin(0.2 * n);
+        u = 0.5 * cos(0.13 * n);
+        v = 0.2 - 0.1 * sin(0.17 * n);
+        w = -0.1 + 0.2 * cos(0.11 * n);
+        p = 1.0 + 0.2 * sin(0.07 * n);
+        if (40 <= n) { /* contact */
+            rho = 0.5 * rho;
+        }
+        if (80 <= n) { /* shock */
+            rho = 3.0 * rho;
+            u = u + 1.5;
+            p = 10.0 * p;
+        }
+        node->U[TO][0][n] = rho;
+        node->U[TO][1][n] = rho * u;
+        node->U[TO][2][n] = rho * v;
+        node->U[TO][3][n] = rho * w;
+        node->U[TO][4][n] = p / (gamma - 1.0) + 0.5 * rho * (u * u + v * v + w * w);
+    }
+    return;
+}
+/* a good practice: end file with a newline */
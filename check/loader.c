@@ -0,0 +1,60 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
+#include "../stl.h"
+#include "../computational_geometry.h"
+#include "../timer.h"
+#include "../commons.h"
+/****************************************************************************
+ * The Main Function
+ ****************************************************************************/
+/*
+ * Time the loading of triangulated polyhedrons: reading each binary STL
+ * file given in the arguments, and converting the facets into the face,
+ * edge, and vertex representation, where vertices are welded and edges
+ * are paired. The Euler characteristic, vertN - edgeN + faceN, checks the
+ * welding: 2 for a closed sphere and 0 for a torus.
+ */
+int main(int argc, char *argv[])
+{
+    Timer tm;
+    Polyhedron poly = {.faceN = 0};
+    double tRead = 0.0, tConvert = 0.0; /* elapsed seconds */
+    if (2 > argc) {
+        fprintf(stderr, "usage: loader file.stl ...\n");
+        exit(EXIT_FAILURE);
+    }
+    printf("%10s %10s %10s %6s %10s %10s  %s\n",
+            "faces", "edges", "vertices", "euler", "read(s)", "convert(s)", "file");
+    for (int n = 1; n < argc; ++n) {
+        poly = (Polyhedron){.faceN = 0};
+        TickTime(&tm);
+        ReadStlFile(argv[n], &poly);
+        tRead = TockTime(&tm);
+        TickTime(&tm);
+        ConvertPolyhedron(&poly);
+        tConvert = TockTime(&tm);
+        printf("%10d %10d %10d %6d %10.4f %10.4f  %s\n", poly.faceN, poly.edgeN, poly.vertN,
+                poly.vertN - poly.edgeN + poly.faceN, tRead, tConvert, argv[n]);
+        RetrieveStorage(poly.f);
+        RetrieveStorage(poly.Nf);
+        RetrieveStorage(poly.e);
+        RetrieveStorage(poly.Ne);
+        RetrieveStorage(poly.v);
+        RetrieveStorage(poly.Nv);
+    }
+    exit(EXIT_SUCCESS);
+}
+/* a good practice: end file with a newline */
@@ -0,0 +1,118 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
+#include <string.h> /* manipulating strings */
+#include <math.h> /* common mathematical functions */
+#include "../stl.h"
+#include "../commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void SpherePoint(const int, const int, const int, const int, Real [restrict]);
+static void TorusPoint(const int, const int, const int, const int, Real [restrict]);
+static void AddFacet(const Real [restrict], const Real [restrict], const Real [restrict],
+        Polyhedron *);
+/****************************************************************************
+ * The Main Function
+ ****************************************************************************/
+/*
+ * Generate a watertight triangulated unit sphere or torus as a binary STL
+ * file for the checks and benchmarks. The facet count is set by the
+ * number of divisions in the two surface parameters:
+ *     mkstl sphere nt np file    2 * np * (nt - 1) facets
+ *     mkstl torus nu nv file     2 * nu * nv facets
+ * The torus has a unit major radius, a minor radius of 0.4, and is
+ * stretched along z so that it is not axisymmetric about any axis.
+ */
+int main(int argc, char *argv[])
+{
+    if (5 != argc) {
+        fprintf(stderr, "usage: mkstl sphere|torus n1 n2 file\n");
+        exit(EXIT_FAILURE);
+    }
+    const int sphere = (0 == strcmp(argv[1], "sphere"));
+    const int n1 = atoi(argv[2]);
+    const int n2 = atoi(argv[3]);
+    if ((!sphere && (0 != strcmp(argv[1], "torus"))) || (3 > n1) || (3 > n2)) {
+        fprintf(stderr, "usage: mkstl sphere|torus n1 n2 file, n1, n2 >= 3\n");
+        exit(EXIT_FAILURE);
+    }
+    Polyhedron poly = {.faceN = 0};
+    poly.facet = AssignStorage(2 * n1 * n2 * sizeof(*poly.facet));
+    RealVec a = {0.0}, b = {0.0}, c = {0.0}, d = {0.0}; /* corners of a parameter cell */
+    for (int i = 0; i < n1; ++i) {
+        for (int j = 0; j < n2; ++j) {
+            if (sphere) {
+                SpherePoint(i, j, n1, n2, a);
+                SpherePoint(i + 1, j, n1, n2, b);
+                SpherePoint(i + 1, j + 1, n1, n2, c);
+                SpherePoint(i, j + 1, n1, n2, d);
+                if (0 < i) { /* the polar cells are triangles */
+                    AddFacet(a, b, d, &poly);
+                }
+                if (n1 - 1 > i) {
+                    AddFacet(b, c, d, &poly);
+                }
+            } else {
+                TorusPoint(i, j, n1, n2, a);
+                TorusPoint(i + 1, j, n1, n2, b);
+                TorusPoint(i + 1, j + 1, n1, n2, c);
+                TorusPoint(i, j + 1, n1, n2, d);
+                AddFacet(a, b, c, &poly);
+                AddFacet(a, c, d, &poly);
+            }
+        }
+    }
+    WriteStlFile(argv[4], &poly);
+    printf("%s: %d facets\n", argv[4], poly.faceN);
+    RetrieveStorage(poly.facet);
+    exit(EXIT_SUCCESS);
+}
+/*
+ * Latitude i of nt from the north pole and longitude j of np. The polar
+ * points are shared by all longitudes so that the surface is closed.
+ */
+static void SpherePoint(const int i, const int j, const int nt, const int np, Real p[restrict])
+{
+    const Real theta = PI * (Real)i / (Real)nt;
+    const Real phi = 2.0 * PI * (Real)(j % np) / (Real)np;
+    p[X] = ((0 == i) || (nt == i)) ? 0.0 : sin(theta) * cos(phi);
+    p[Y] = ((0 == i) || (nt == i)) ? 0.0 : sin(theta) * sin(phi);
+    p[Z] = cos(theta);
+    return;
+}
+static void TorusPoint(const int i, const int j, const int nu, const int nv, Real p[restrict])
+{
+    const Real u = 2.0 * PI * (Real)(i % nu) / (Real)nu;
+    const Real v = 2.0 * PI * (Real)(j % nv) / (Real)nv;
+    p[X] = (1.0 + 0.4 * cos(v)) * cos(u);
+    p[Y] = (1.0 + 0.4 * cos(v)) * sin(u);
+    p[Z] = 0.4 * 1.3 * sin(v);
+    return;
+}
+static void AddFacet(const Real v0[restrict], const Real v1[restrict], const Real v2[restrict],
+        Polyhedron *poly)
+{
+    Facet *facet = poly->facet + poly->faceN;
+    for (int s = 0; s < DIMS; ++s) {
+        facet->v0[s] = v0[s];
+        facet->v1[s] = v1[s];
+        facet->v2[s] = v2[s];
+        facet->N[s] = 0.0; /* the solver computes normals from vertices */
+    }
+    ++(poly->faceN);
+    return;
+}
+/* a good practice: end file with a newline */
@@ -0,0 +1,379 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* file mapping interface under strict C99 */
+#include "checkpoint.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h> /* file control options */
+#include <sys/mman.h> /* memory management declarations */
+#include <sys/stat.h> /* file status */
+#include <unistd.h> /* standard symbolic constants and types */
+#endif
+#include "computational_geometry.h"
+#include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void NameCheckpoint(const int, const Partition *const, const char *, CkStr);
+static void WriteBlock(const void *, const size_t, CkStream *);
+static void ReadBlock(void *, const size_t, CkStream *);
+static unsigned long long Checksum(const unsigned char *, const size_t, unsigned long long);
+static void RestorePolyState(const Polyhedron *, Polyhedron *);
+static unsigned char *MapFile(const char *, size_t *);
+static void UnmapFile(unsigned char *, const size_t);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const char magic[CKMAGIC] = {'A', 'R', 'T', 'R', 'A', 'C', 'F', 'D'}; /* file signature */
+static const unsigned long long seed = 0xcbf29ce484222325ULL; /* checksum offset basis */
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * The checkpoint is a sequence of blocks, each one a raw memory image padded
+ * to a multiple of CKALIGN bytes: a header, the node flags and conservative
+ * variables as whole arrays, the ghost node lists, the polyhedron records
+ * with the face, edge and vertex lists of triangulated polyhedrons, and the
+ * contact neighbour list. A checksum of all the blocks closes the file.
+ * Derived geometric data, such as normals and bounding volume hierarchies,
+ * are rebuilt on reading from the body frame vertices.
+ */
+void WriteCheckpoint(const Time *time, const Space *space)
+{
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    const Geometry *const geo = &(space->geo);
+    const int totN = part->n[X] * part->n[Y] * part->n[Z];
+    CkStr fname = {'\0'};
+    CkStr tname = {'\0'};
+    NameCheckpoint(time->dataC, part, ".dat", fname);
+    NameCheckpoint(time->dataC, part, ".tmp", tname);
+    CkStream stream = {.fp = Fopen(tname, "wb"), .data = NULL, .size = 0, .pos = 0, .sum = seed};
+    setvbuf(stream.fp, NULL, _IOFBF, CKBUFN);
+    /* header with time counters */
+    CkHead head;
+    memset(&head, 0, sizeof(head)); /* padding bytes are part of the checksum */
+    memcpy(head.magic, magic, sizeof(magic));
+    head.version = CKVERSION;
+    head.sizeR = sizeof(Real);
+    head.sizeP = sizeof(Polyhedron);
+    head.rank = part->rank;
+    head.rankN = part->rankN;
+    for (int s = 0; s < DIMS; ++s) {
+        head.n[s] = part->n[s];
+        head.no[s] = part->no[s];
+    }
+    head.totN = geo->totN;
+    head.sphN = geo->sphN;
+    head.stepC = time->stepC;
+    head.dataC = time->dataC;
+    head.now = time->now;
+    for (int n = 0; n < NPROBE; ++n) {
+        head.rcData[n] = time->rcData[n];
+    }
+    head.rcInt = time->rcInt;
+    head.statN = (NULL == node->stat) ? 0 : DIMSTAT;
+    head.statC = time->statC;
+    WriteBlock(&head, sizeof(head), &stream);
+    /* field data */
+    WriteBlock(node->did, totN * sizeof(*node->did), &stream);
+    WriteBlock(node->fid, totN * sizeof(*node->fid), &stream);
+    WriteBlock(node->lid, totN * sizeof(*node->lid), &stream);
+    WriteBlock(node->gst, totN * sizeof(*node->gst), &stream);
+    for (int n = 0; n < DIMU; ++n) {
+        WriteBlock(node->U[TO][n], totN * sizeof(*node->U[TO][n]), &stream);
+    }
+    /* ghost node lists */
+    const int ghostN = geo->ghostN[part->gl];
+    const int stenN = geo->ghost[ghostN][3];
+    WriteBlock(geo->ghostN, sizeof(geo->ghostN), &stream);
+    WriteBlock(geo->ghost, (ghostN + 1) * sizeof(*geo->ghost), &stream);
+    WriteBlock(geo->ghostO, (ghostN + 1) * sizeof(*geo->ghostO), &stream);
+    WriteBlock(geo->sten, (stenN + 1) * sizeof(*geo->sten), &stream);
+    WriteBlock(geo->stenW, (stenN + 1) * sizeof(*geo->stenW), &stream);
+    /* geometry data, pointers are cleared for a reproducible record */
+    Polyhedron image;
+    for (int n = 0; n < geo->totN; ++n) {
+        const Polyhedron *poly = geo->poly + n;
+        memcpy(&image, poly, sizeof(image));
+        image.f = NULL;
+        image.Nf = NULL;
+        image.e = NULL;
+        image.Ne = NULL;
+        image.v = NULL;
+        image.Nv = NULL;
+        image.facet = NULL;
+        image.bvh = NULL;
+        image.fo = NULL;
+        WriteBlock(&image, sizeof(image), &stream);
+        if (0 < poly->faceN) {
+            WriteBlock(poly->f, poly->faceN * sizeof(*poly->f), &stream);
+            WriteBlock(poly->e, poly->edgeN * sizeof(*poly->e), &stream);
+            WriteBlock(poly->v, poly->vertN * sizeof(*poly->v), &stream);
+        }
+    }
+    /* contact neighbour list, NONE if not built yet */
+    const int pairN = (NULL == geo->pair) ? NONE : geo->pairN;
+    WriteBlock(&pairN, sizeof(pairN), &stream);
+    if (NONE != pairN) {
+        WriteBlock(geo->pair, (pairN + 1) * sizeof(*geo->pair), &stream);
+    }
+    WriteBlock(geo->drift, geo->totN * sizeof(*geo->drift), &stream);
+    /* running statistics */
+    WriteBlock(node->stat, (size_t)totN * head.statN * sizeof(*node->stat), &stream);
+    fwrite(&(stream.sum), sizeof(stream.sum), 1, stream.fp);
+    if (0 != fclose(stream.fp)) {
+        ShowError("failed to write file: %s", tname);
+    }
+    /* replace the previous checkpoint only when the new one is complete */
+    if (0 != rename(tname, fname)) {
+        ShowWarning("failed to rename file: %s\n", tname);
+    }
+    return;
+}
+int ReadCheckpoint(Time *time, Space *space)
+{
+    const Partition *const part = &(space->part);
+    Node *const node = space->node;
+    Geometry *const geo = &(space->geo);
+    const int totN = part->n[X] * part->n[Y] * part->n[Z];
+    CkStr fname = {'\0'};
+    NameCheckpoint(time->dataC, part, ".dat", fname);
+    CkStream stream = {.fp = NULL, .data = NULL, .size = 0, .pos = 0, .sum = seed};
+    stream.data = MapFile(fname, &(stream.size));
+    if (NULL == stream.data) {
+        ShowWarning("no checkpoint: %s, restart from data files\n", fname);
+        return 1;
+    }
+    /* verify the integrity before restoring anything */
+    unsigned long long sum = 0;
+    const size_t bodyN = stream.size - sizeof(sum);
+    memcpy(&sum, stream.data + bodyN, sizeof(sum));
+    if ((0 != memcmp(stream.data, magic, sizeof(magic))) || (Checksum(stream.data, bodyN, seed) != sum)) {
+        ShowError("corrupted checkpoint: %s", fname);
+    }
+    stream.size = bodyN;
+    CkHead head;
+    ReadBlock(&head, sizeof(head), &stream);
+    if ((CKVERSION != head.version) || (sizeof(Real) != (size_t)head.sizeR) ||
+            (sizeof(Polyhedron) != (size_t)head.sizeP)) {
+        ShowError("incompatible checkpoint version: %s", fname);
+    }
+    if ((part->rank != head.rank) || (part->rankN != head.rankN) ||
+            (part->n[X] != head.n[X]) || (part->n[Y] != head.n[Y]) || (part->n[Z] != head.n[Z]) ||
+            (part->no[X] != head.no[X]) || (part->no[Y] != head.no[Y]) || (part->no[Z] != head.no[Z]) ||
+            (geo->totN != head.totN) || (geo->sphN != head.sphN) || (time->dataC != head.dataC)) {
+        ShowError("checkpoint mismatches the case: %s", fname);
+    }
+    time->stepC = head.stepC;
+    time->now = head.now;
+    for (int n = 0; n < NPROBE; ++n) {
+        time->rcData[n] = head.rcData[n];
+    }
+    time->rcInt = head.rcInt;
+    /* field data */
+    ReadBlock(node->did, totN * sizeof(*node->did), &stream);
+    ReadBlock(node->fid, totN * sizeof(*node->fid), &stream);
+    ReadBlock(node->lid, totN * sizeof(*node->lid), &stream);
+    ReadBlock(node->gst, totN * sizeof(*node->gst), &stream);
+    for (int n = 0; n < DIMU; ++n) {
+        ReadBlock(node->U[TO][n], totN * sizeof(*node->U[TO][n]), &stream);
+    }
+    /* ghost node lists */
+    ReadBlock(geo->ghostN, sizeof(geo->ghostN), &stream);
+    const int ghostN = geo->ghostN[part->gl];
+    RetrieveStorage(geo->ghost);
+    RetrieveStorage(geo->ghostO);
+    geo->ghost = AssignStorage((ghostN + 1) * sizeof(*geo->ghost));
+    geo->ghostO = AssignStorage((ghostN + 1) * sizeof(*geo->ghostO));
+    ReadBlock(geo->ghost, (ghostN + 1) * sizeof(*geo->ghost), &stream);
+    ReadBlock(geo->ghostO, (ghostN + 1) * sizeof(*geo->ghostO), &stream);
+    const int stenN = geo->ghost[ghostN][3];
+    RetrieveStorage(geo->sten);
+    RetrieveStorage(geo->stenW);
+    geo->sten = AssignStorage((stenN + 1) * sizeof(*geo->sten));
+    geo->stenW = AssignStorage((stenN + 1) * sizeof(*geo->stenW));
+    ReadBlock(geo->sten, (stenN + 1) * sizeof(*geo->sten), &stream);
+    ReadBlock(geo->stenW, (stenN + 1) * sizeof(*geo->stenW), &stream);
+    /* geometry data */
+    Polyhedron *image = AssignStorage((geo->totN + 1) * sizeof(*image));
+    Polyhedron *poly = NULL;
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        ReadBlock(image + n, sizeof(*image), &stream);
+        *poly = image[n];
+        if (0 < poly->faceN) {
+            AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, poly);
+            ReadBlock(poly->f, poly->faceN * sizeof(*poly->f), &stream);
+            ReadBlock(poly->e, poly->edgeN * sizeof(*poly->e), &stream);
+            ReadBlock(poly->v, poly->vertN * sizeof(*poly->v), &stream);
+        }
+    }
+    /* rebuild derived data from the body frame, then restore the state */
+    ComputeGeometryParameters(part->collapse, geo);
+    for (int n = 0; n < geo->totN; ++n) {
+        RestorePolyState(image + n, geo->poly + n);
+    }
+    RetrieveStorage(image);
+    /* contact neighbour list */
+    int pairN = NONE;
+    ReadBlock(&pairN, sizeof(pairN), &stream);
+    if (NONE != pairN) {
+        RetrieveStorage(geo->pair);
+        geo->pair = AssignStorage((pairN + 1) * sizeof(*geo->pair));
+        ReadBlock(geo->pair, (pairN + 1) * sizeof(*geo->pair), &stream);
+        geo->pairN = pairN;
+    }
+    ReadBlock(geo->drift, geo->totN * sizeof(*geo->drift), &stream);
+    /* running statistics, kept only if sampled by both runs */
+    if ((0 != head.statN) && (DIMSTAT != head.statN)) {
+        ShowError("incompatible checkpoint statistics: %s", fname);
+    }
+    if ((NULL != node->stat) && (0 == head.statN)) {
+        ShowWarning("no statistics in checkpoint, statistics start from the restart");
+    }
+    time->statC = (NULL == node->stat) ? 0 : head.statC;
+    ReadBlock(node->stat, (size_t)totN * head.statN * sizeof(*node->stat), &stream);
+    if (stream.pos != stream.size) {
+        ShowError("corrupted checkpoint: %s", fname);
+    }
+    UnmapFile(stream.data, bodyN + sizeof(sum));
+    return 0;
+}
+static void NameCheckpoint(const int n, const Partition *const part, const char *fext, CkStr fname)
+{
+    if (1 < part->rankN) { /* a file series for each processor */
+        snprintf(fname, sizeof(CkStr), "checkpoint_%04d_%05d%s", part->rank, n, fext);
+    } else {
+        snprintf(fname, sizeof(CkStr), "checkpoint%05d%s", n, fext);
+    }
+    return;
+}
+static void WriteBlock(const void *data, const size_t size, CkStream *stream)
+{
+    const unsigned char pad[CKALIGN] = {0};
+    const size_t padN = (CKALIGN - size % CKALIGN) % CKALIGN;
+    if (0 != size) {
+        fwrite(data, size, 1, stream->fp);
+        stream->sum = Checksum(data, size, stream->sum); /* padding included */
+    }
+    if (0 != padN) {
+        fwrite(pad, padN, 1, stream->fp);
+    }
+    return;
+}
+static void ReadBlock(void *data, const size_t size, CkStream *stream)
+{
+    const size_t padN = (CKALIGN - size % CKALIGN) % CKALIGN;
+    if (stream->size - stream->pos < size + padN) {
+        ShowError("checkpoint data shorter than expected");
+    }
+    if ((NULL != data) && (0 != size)) { /* a null destination skips the block */
+        memcpy(data, stream->data + stream->pos, size);
+    }
+    stream->pos = stream->pos + size + padN;
+    return;
+}
+/*
+ * A word-wise variant of the FNV-1a hash with a xor-shift fold, for the
+ * detection of truncated or damaged files. Since blocks are padded to whole
+ * words, hashing the blocks one by one equals hashing the file at once.
+ */
+static unsigned long long Checksum(const unsigned char *byte, const size_t size, unsigned long long sum)
+{
+    const unsigned long long prime = 0x100000001b3ULL;
+    unsigned long long word = 0;
+    size_t n = 0;
+    for (n = 0; n + CKALIGN <= size; n = n + CKALIGN) {
+        memcpy(&word, byte + n, CKALIGN);
+        sum = (sum ^ word) * prime;
+        sum = sum ^ (sum >> 32);
+    }
+    if (n < size) { /* a partial word is padded with zeros */
+        word = 0;
+        memcpy(&word, byte + n, size - n);
+        sum = (sum ^ word) * prime;
+        sum = sum ^ (sum >> 32);
+    }
+    return sum;
+}
+static void RestorePolyState(const Polyhedron *image, Polyhedron *poly)
+{
+    const Polyhedron mesh = *poly; /* keep the mesh data just rebuilt */
+    *poly = *image;
+    poly->f = mesh.f;
+    poly->Nf = mesh.Nf;
+    poly->e = mesh.e;
+    poly->Ne = mesh.Ne;
+    poly->v = mesh.v;
+    poly->Nv = mesh.Nv;
+    poly->facet = mesh.facet;
+    poly->bvh = mesh.bvh;
+    poly->fo = mesh.fo;
+    return;
+}
+/*
+ * Map a file into memory, the pages are brought in on demand as the blocks
+ * are copied out. Return NULL if the file does not exist.
+ */
+static unsigned char *MapFile(const char *fname, size_t *size)
+{
+    const size_t minN = sizeof(CkHead) + sizeof(unsigned long long);
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = open(fname, O_RDONLY);
+    if (0 > fd) {
+        return NULL;
+    }
+    struct stat st;
+    if ((0 != fstat(fd, &st)) || (minN > (size_t)st.st_size)) {
+        ShowError("corrupted checkpoint: %s", fname);
+    }
+    *size = st.st_size;
+    void *data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data) {
+        ShowError("failed to map file: %s", fname);
+    }
+    posix_madvise(data, *size, POSIX_MADV_SEQUENTIAL);
+    return data;
+#else
+    FILE *fp = fopen(fname, "rb");
+    if (NULL == fp) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    const long n = ftell(fp);
+    if ((0 > n) || (minN > (size_t)n)) {
+        ShowError("corrupted checkpoint: %s", fname);
+    }
+    *size = n;
+    rewind(fp);
+    unsigned char *data = AssignStorage(*size);
+    Fread(data, 1, *size, fp);
+    fclose(fp);
+    return data;
+#endif
+}
+static void UnmapFile(unsigned char *data, const size_t size)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    munmap(data, size);
+#else
+    (void)size;
+    RetrieveStorage(data);
+#endif
+    return;
+}
+/* a good practice: end file with a newline */
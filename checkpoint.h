@@ -0,0 +1,82 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_CHECKPOINT_H_ /* if undefined */
+#define ARTRACFD_CHECKPOINT_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    CKSTR = 80, /* string data length */
+    CKVERSION = 3, /* version of the checkpoint layout */
+    CKMAGIC = 8, /* length of the file signature */
+    CKALIGN = 8, /* blocks are padded to a multiple of this word size */
+    CKBUFN = 1048576, /* bytes of the file stream buffer */
+} CkConst;
+typedef char CkStr[CKSTR]; /* string data */
+typedef struct {
+    char magic[CKMAGIC]; /* file signature */
+    int version; /* version of the checkpoint layout */
+    int sizeR; /* bytes of a real value */
+    int sizeP; /* bytes of a polyhedron record */
+    int rank; /* rank of the writing processor */
+    int rankN; /* number of processors */
+    IntVec n; /* node number of spatial dimensions */
+    IntVec no; /* node index of the global domain origin */
+    int totN; /* total number of geometries */
+    int sphN; /* number of analytical polyhedrons */
+    int stepC; /* step number count */
+    int dataC; /* data writing count */
+    int statN; /* number of statistics values of a node, 0 if none */
+    int statC; /* statistics sample count */
+    Real now; /* current time recorder */
+    Real rcData[NPROBE]; /* accumulated time of each data probe type */
+    Real rcInt; /* time instant recorder */
+} CkHead; /* checkpoint file header */
+typedef struct {
+    FILE *fp; /* data file of writing */
+    unsigned char *data; /* mapped data file of reading */
+    size_t size; /* bytes of mapped data */
+    size_t pos; /* position of the next block in mapped data */
+    unsigned long long sum; /* running checksum */
+} CkStream; /* checkpoint data stream */
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Checkpoint writer
+ *
+ * Function
+ *      Dump the exact computing state of the current processor, that is,
+ *      the conservative variables at the current time level, the node
+ *      flags, the ghost node lists, the geometry state, the running
+ *      statistics and the time counters, in native binary with a trailing
+ *      checksum.
+ */
+extern void WriteCheckpoint(const Time *, const Space *);
+/*
+ * Checkpoint reader
+ *
+ * Function
+ *      Restore the computing state dumped by the checkpoint writer for the
+ *      restart data count, after which the computation continues exactly
+ *      as it would without interruption.
+ *      Return 0 if restored, 1 if there is no checkpoint to restore.
+ */
+extern int ReadCheckpoint(Time *, Space *);
+#endif
+/* a good practice: end file with a newline */
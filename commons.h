@@ -42,23 +42,30 @@ typedef enum {
     COLLAPSEYZ = 8,
     COLLAPSEXYZ = 17,
     /* dimensions related to temporal operator */
-    DIMT = 3, /* number of time levels to store field data */
+    DIMT = 3, /* maximum number of time levels to store field data */
     TO = 0, /* the time level for current */
     TN = 1, /* the time level for intermediate */
     TM = 2, /* the time level for intermediate */
     /* dimensions related to field variables */
     DIMU = 5, /* conservative vector: rho, rho_u, rho_v, rho_w, rho_eT */
     DIMUo = 6, /* primitive vector: rho, u, v, w, [p, hT, h], [T, c] */
+    DIMSTAT = 15, /* running statistics: means and second moments of rho, u, v, w, p, T, and uv, uw, vw */
+    ALIGNB = 64, /* byte alignment of field data arrays */
     /* parameters related to numerical model */
     PATHN = 30, /* neighbour searching path */
     PATHSEP = 4, /* layer separator in neighbour searching path: pathN, l1N, l2N, l3N */
     NONE = -1, /* invalid flag */
+    BATCHN = 16, /* number of interfaces in a batched flux computation */
     WENOTHREE = 0, /* 3rd order weno */
     WENOFIVE = 1, /* 5th order weno */
     OPTSPLIT = 0, /* operator splitting approximation */
     OPTBYOPT = 1, /* operator-by-operator approximation */
+    RKTWO = 0, /* 2nd order runge-kutta */
+    RKTHREE = 1, /* 3rd order runge-kutta */
+    LSRKTHREE = 2, /* 3rd order low-storage runge-kutta */
+    LSRKFOUR = 3, /* 4th order low-storage runge-kutta */
     /* parameters related to domain partitions */
-    NPART = 15, /* inner region, [west, east, south, north, front, back] x [Boundary, Ghost], physical region, all region */
+    NPART = 16, /* inner region, [west, east, south, north, front, back] x [Boundary, Ghost], physical region, all region, exchange region */
     PIO = 0, /* the partition region for data iostream */
     PIN = 0,
     PWB = 1,
@@ -75,6 +82,7 @@ typedef enum {
     PBG = 12,
     PHY = 13,
     PAL = 14,
+    PEX = 15,
     LIMIT = 2, /* number of limits */
     MIN = 0,
     MAX = 1,
@@ -97,16 +105,22 @@ typedef enum {
     VARIC = 5, /* specified primitive variables: rho, u, v, w, p */
     /* parameters related to geometry */
     DIMTK = 2, /* number of time levels to store kinematic data */
+    DIMQ = 4, /* quaternion components: w, x, y, z */
     POLYN = 3, /* polygon facet type */
     EVF = 4, /* edge-vertex-face type */
+    GSTN = 4, /* ghost node list entry: node index, geometry index, face identifier, stencil pointer */
+    GSTO = 7, /* ghost node boundary data: boundary point, normal, boundary weight */
+    SKINN = 2, /* neighbour list skin in the largest cell size */
     /* parameters related to data probes */
-    NPROBE = 5, /* point, line, curve, force, space probe */
+    NPROBE = 6, /* point, line, curve, force, slice, space probe */
     PROPT = 0,
     PROLN = 1,
     PROCV = 2,
     PROFC = 3,
-    PROSD = 4,
+    PROSL = 4,
+    PROSD = 5,
     POSLN = 7, /* x1, y1, z1, x2, y2, z2, resolution */
+    POSSL = 2, /* normal axis, coordinate */
     /* general parameters */
     STR = 200, /* string length */
     VARSTR =100, /* variable expression length */
@@ -125,13 +139,21 @@ extern const Real PI;
 /*
  * Member structures
  */
+/*
+ * Field data are stored as one array per flag and per variable, which the
+ * batched convective flux loads contiguously. Compared with a record per
+ * node, a serial run costs about the same; no time gain was measured.
+ */
 typedef struct {
-    int did; /* domain identifier */
-    int fid; /* closest face identifier */
-    int lid; /* interfacial layer identifier */
-    int gst; /* ghost layer identifier */
-    Real U[DIMT][DIMU]; /* field data at each time level */
-} Node; /* field data */
+    int *did; /* domain identifier */
+    int *fid; /* closest face identifier */
+    int *lid; /* interfacial layer identifier */
+    int *gst; /* ghost layer identifier */
+    Real *U[DIMT][DIMU]; /* each conservative variable at each time level */
+    int levelN; /* number of allocated time levels */
+    void *pool; /* storage block holding all the arrays */
+    Real *stat; /* running statistics, DIMSTAT values per node */
+} Node; /* field data stored as arrays indexed by node */
 
 typedef struct {
     IntVec m; /* mesh number of spatial dimensions */
@@ -156,6 +178,11 @@ typedef struct {
     Real domain[DIMS][LIMIT]; /* coordinates define the space domain */
     IntVec proc; /* number of processors of spatial dimensions */
     int procN; /* total number of processors */
+    int rank; /* rank of current processor in distributed memory */
+    int rankN; /* number of processors in distributed memory */
+    IntVec coord; /* block coordinates of current processor */
+    int nb[NBC]; /* neighbouring processor of each boundary, NONE if physical */
+    IntVec no; /* node index of the global domain origin */
 } Partition; /* domain discretization and partition */
 
 typedef struct {
@@ -165,20 +192,44 @@ typedef struct {
     RealVec v2; /* vertex */
 } Facet; /* polyhedron facet */
 
+typedef struct {
+    Real box[DIMS][LIMIT]; /* bounding box */
+    int child; /* the first of two consecutive child nodes; 0 if leaf */
+    int fs; /* start of faces in the face order list */
+    int fn; /* number of faces */
+} Bvh; /* bounding volume hierarchy node */
+
 typedef struct {
     int gid; /* geometry identifier */
     IntVec N; /* line of impact */
+    IntVec key; /* global node of the first detection */
 } Collision; /* collision list */
 
+typedef struct {
+    int cellM; /* capacity of cell lists */
+    int pairM; /* capacity of pair list */
+    Real (*eb)[DIMS][LIMIT]; /* enlarged bounding boxes */
+    int *cell; /* cell holding the lower corner of each enlarged box */
+    int *head; /* start of each cell in binned polyhedron list */
+    int *top; /* filled number of each cell */
+    int *list; /* polyhedrons binned by cells */
+    int (*pair)[2]; /* listed pairs */
+} Binning; /* broad phase workspace kept across calls */
+
 typedef struct {
     int faceN; /* number of faces. <=0 for analytical polyhedron */
     int edgeN; /* number of edges */
     int vertN; /* number of vertices */
+    int bvhN; /* number of bounding volume hierarchy nodes */
     int state; /* dynamic motion indicator */
     int mid; /* material type */
     Real r; /* bounding sphere radius */
     RealVec O; /* centroid */
     Real I[DIMS][DIMS]; /* inertia matrix */
+    RealVec Ob; /* centroid in body frame */
+    Real q[DIMQ]; /* unit quaternion of body frame orientation */
+    Real R[DIMS][DIMS]; /* rotation matrix of body frame orientation */
+    Real Ib[DIMS][DIMS]; /* inertia matrix in body frame */
     Real V[DIMTK][DIMS]; /* translational velocity */
     Real W[DIMTK][DIMS]; /* rotational velocity */
     Real at[DIMTK][DIMS]; /* translational acceleration */
@@ -201,6 +252,8 @@ typedef struct {
     Real (*restrict v)[DIMS]; /* vertex list */
     Real (*restrict Nv)[DIMS]; /* vertex normal */
     Facet *facet; /* facet data */
+    Bvh *bvh; /* bounding volume hierarchy of faces */
+    int *restrict fo; /* face order list of bounding volume hierarchy */
 } Polyhedron; /* polyhedron */
 
 typedef struct {
@@ -208,8 +261,17 @@ typedef struct {
     int sphN; /* number of analytical polyhedrons */
     int stlN; /* number of triangulated polyhedrons */
     int colN; /* colliding list pointer and count */
+    int pairN; /* number of pairs in neighbour list */
+    int ghostN[PATHSEP]; /* end of each ghost layer in ghost node list */
     Polyhedron *poly; /* geometry list */
     Collision *col; /* collision list */
+    Binning bin; /* broad phase workspace */
+    int (*pair)[2]; /* neighbour list of contact pairs */
+    Real *drift; /* drift of polyhedrons since the neighbour list built */
+    int (*ghost)[GSTN]; /* ghost node list grouped by ghost layer */
+    Real (*ghostO)[GSTO]; /* boundary data of ghost nodes */
+    int *sten; /* interpolation stencil node list of ghost nodes */
+    Real *stenW; /* interpolation stencil weight list of ghost nodes */
 } Geometry; /* geometry data */
 
 typedef struct {
@@ -233,12 +295,19 @@ typedef struct {
     int dataN[NPROBE]; /* number for each data probe type */
     int dataW[NPROBE]; /* writing frequency for each data probe type */
     int dataStreamer; /* data streamer */
+    int dataFormat; /* data encoding format */
     int dataC; /* data writing count */
+    int statW; /* statistics sampling interval in steps */
+    int statC; /* statistics sample count */
+    int ckW; /* checkpoint interval in space data exports, 0 if off */
     Real end; /* termination time */
     Real now; /* current time recorder */
     Real numCFL; /* CFL number */
+    Real rcData[NPROBE]; /* accumulated time of each data probe type */
+    Real rcInt; /* time instant recorder */
     Real (*restrict pp)[DIMS]; /* point probes */
     Real (*restrict lp)[POSLN]; /* line probes */
+    Real (*restrict sp)[POSSL]; /* slice probes */
 } Time;
 
 typedef struct {
@@ -251,6 +320,7 @@ typedef struct {
     int fluxSplit; /* flux vector splitting method */
     int psi; /* phase interaction type */
     int ibmLayer; /* number of interfacial layers using flow reconstruction */
+    int nodeMap; /* domain-node mapping method for triangulated polyhedrons */
     int mid; /* material identifier */
     int gState; /* gravity state */
     int sState; /* source state */
@@ -264,6 +334,7 @@ typedef struct {
     Real refV;  /*characteristic velocity */
     Real refT; /* characteristic temperature */
     RealVec g; /* gravity vector */
+    Real kn; /* normal contact stiffness */
     Material *mat; /* material database */
 } Model;
 
@@ -15,14 +15,25 @@
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
 #include <string.h> /* manipulating strings */
+#include <stdint.h> /* fixed width integer types */
 #include <math.h> /* common mathematical functions */
 #include <float.h> /* size of floating point values */
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    BVHL = 4, /* maximum number of faces in a leaf node */
+    BVHS = 64, /* traversal stack size, exceeds the depth of median split */
+} GeoConst;
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static int AddVertex(const Real [restrict], Polyhedron *);
+static int HashCapacity(const int);
+static uint64_t HashMix(uint64_t);
+static int AddVertex(const Real [restrict], const int, int [restrict], Polyhedron *);
+static void AddEdge(const int, const int, const int, const int, int [restrict], Polyhedron *);
 static int FindEdge(const int, const int, const int, int [restrict][EVF]);
 static void ComputeParametersSphere(const int, Polyhedron *);
 static void ComputeParametersPolyhedron(const int, Polyhedron *);
@@ -31,6 +42,15 @@ static void TransformVertex(const Real [restrict], const Real [restrict],
         const int, Real [restrict][DIMS]);
 static void TransformNormal(const Real [restrict][DIMS], const int, Real [restrict][DIMS]);
 static Real TransformInertia(const Real [restrict], Real [restrict][DIMS]);
+static int IdentityPose(const Polyhedron *);
+static void BuildBvh(Polyhedron *);
+static void SplitBvh(const int, const int, const int, Real [restrict][DIMS], Polyhedron *);
+static void SelectFace(const int, const int, const int, Real [restrict][DIMS], int [restrict]);
+static void BoundBvh(Bvh *, const Polyhedron *);
+static void RefitBvh(Polyhedron *);
+static Real PointBoxDistance(const Real [restrict], const Real [restrict][LIMIT]);
+static Real IntersectFace(const Real [restrict], const int, const Polyhedron *,
+        Real [restrict], Real [restrict]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -38,16 +58,19 @@ void ConvertPolyhedron(Polyhedron *poly)
 {
     /* allocate memory, assume over-estimated vertex and edge */
     AllocatePolyhedronMemory(POLYN * poly->faceN, POLYN * poly->faceN, poly->faceN, poly);
-    /* convert representation */
+    /* convert representation, weld vertices by a hash table of vertex indices */
+    const int cap = HashCapacity(POLYN * poly->faceN);
+    int *table = AssignStorage(cap * sizeof(*table));
+    for (int n = 0; n < cap; ++n) {
+        table[n] = NONE;
+    }
     for (int n = 0; n < poly->faceN; ++n) {
-        poly->f[n][0] = AddVertex(poly->facet[n].v0, poly);
-        poly->f[n][1] = AddVertex(poly->facet[n].v1, poly);
-        poly->f[n][2] = AddVertex(poly->facet[n].v2, poly);
-        AddEdge(poly->f[n][0], poly->f[n][1], n, poly);
-        AddEdge(poly->f[n][1], poly->f[n][2], n, poly);
-        AddEdge(poly->f[n][2], poly->f[n][0], n, poly);
+        poly->f[n][0] = AddVertex(poly->facet[n].v0, cap, table, poly);
+        poly->f[n][1] = AddVertex(poly->facet[n].v1, cap, table, poly);
+        poly->f[n][2] = AddVertex(poly->facet[n].v2, cap, table, poly);
     }
-    QuickSortEdge(poly->edgeN, poly->e);
+    RetrieveStorage(table);
+    BuildEdgeList(poly);
     /* adjust the memory allocation */
     RetrieveStorage(poly->facet);
     poly->facet = NULL;
@@ -68,35 +91,85 @@ void AllocatePolyhedronMemory(const int vertN, const int edgeN,
     poly->Nv = AssignStorage(vertN * sizeof(*poly->Nv));
     return;
 }
-static int AddVertex(const Real v[restrict], Polyhedron *poly)
+static int HashCapacity(const int n)
 {
-    /* search the vertex list, if already exist, return the index */
-    for (int n = 0; n < poly->vertN; ++n) {
+    /* a power of two with a load factor no more than one half */
+    int cap = 2;
+    while (cap < 2 * n) {
+        cap *= 2;
+    }
+    return cap;
+}
+static uint64_t HashMix(uint64_t h)
+{
+    /* finalizer of splitmix64 */
+    h ^= h >> 30;
+    h *= UINT64_C(0xbf58476d1ce4e5b9);
+    h ^= h >> 27;
+    h *= UINT64_C(0x94d049bb133111eb);
+    h ^= h >> 31;
+    return h;
+}
+static int AddVertex(const Real v[restrict], const int cap, int table[restrict], Polyhedron *poly)
+{
+    /* hash the coordinates, adding zero maps -0 to +0 to agree with equality */
+    uint64_t h = 0;
+    for (int s = 0; s < DIMS; ++s) {
+        const Real c = v[s] + 0.0;
+        uint64_t bits = 0;
+        memcpy(&bits, &c, sizeof(c));
+        h = HashMix(h ^ bits);
+    }
+    /* probe the table, if already exist, return the index */
+    int k = (int)(h & (uint64_t)(cap - 1));
+    for (int n = table[k]; NONE != n; k = (k + 1) & (cap - 1), n = table[k]) {
         if ((v[X] == poly->v[n][X]) && (v[Y] == poly->v[n][Y]) &&
                 (v[Z] == poly->v[n][Z])) {
             return n;
         }
     }
     /* otherwise, add to the vertex list */
+    table[k] = poly->vertN;
     poly->v[poly->vertN][X] = v[X];
     poly->v[poly->vertN][Y] = v[Y];
     poly->v[poly->vertN][Z] = v[Z];
     ++(poly->vertN); /* increase pointer */
     return (poly->vertN - 1); /* return index */
 }
-void AddEdge(const int v0, const int v1, const int f, Polyhedron *poly)
+void BuildEdgeList(Polyhedron *poly)
+{
+    const int cap = HashCapacity(POLYN * poly->faceN);
+    int *table = AssignStorage(cap * sizeof(*table));
+    for (int n = 0; n < cap; ++n) {
+        table[n] = NONE;
+    }
+    poly->edgeN = 0;
+    for (int n = 0; n < poly->faceN; ++n) {
+        AddEdge(poly->f[n][0], poly->f[n][1], n, cap, table, poly);
+        AddEdge(poly->f[n][1], poly->f[n][2], n, cap, table, poly);
+        AddEdge(poly->f[n][2], poly->f[n][0], n, cap, table, poly);
+    }
+    RetrieveStorage(table);
+    QuickSortEdge(poly->edgeN, poly->e);
+    return;
+}
+static void AddEdge(const int v0, const int v1, const int f, const int cap,
+        int table[restrict], Polyhedron *poly)
 {
     /* insert by a predefined order */
     const int vMax = (v0 > v1) ? v0 : v1;
     const int vMin = (v0 > v1) ? v1 : v0;
-    /* search the edge list, if already exist, add the second face index */
-    for (int n = 0; n < poly->edgeN; ++n) {
+    const uint64_t h = HashMix(((uint64_t)(uint32_t)vMax << 32) | (uint32_t)vMin);
+    /* probe the table, if already exist, add the second face index */
+    int k = (int)(h & (uint64_t)(cap - 1));
+    for (int n = table[k]; NONE != n; k = (k + 1) & (cap - 1), n = table[k]) {
         if ((vMax == poly->e[n][0]) && (vMin == poly->e[n][1])) {
             poly->e[n][3] = f;
             return;
         }
     }
     /* otherwise, add to the edge list */
+    table[k] = poly->edgeN;
     poly->e[poly->edgeN][0] = vMax;
     poly->e[poly->edgeN][1] = vMin;
     poly->e[poly->edgeN][2] = f;
@@ -188,6 +261,8 @@ void TransformPolyhedron(const Real O[restrict], const Real scale[restrict],
     TransformNormal(rotate, poly->faceN, poly->Nf);
     TransformNormal(rotate, poly->edgeN, poly->Ne);
     TransformNormal(rotate, poly->vertN, poly->Nv);
+    /* refit hierarchy to transformed vertices, face topology is unchanged */
+    RefitBvh(poly);
     /* transform inertial tensor */
     for (int n = 0; n < 6; ++n) {
         axis[X] = Dot(invrot[X], axe[n]);
@@ -259,6 +334,124 @@ static Real TransformInertia(const Real axis[restrict], Real I[restrict][DIMS])
         I[Z][Z] * axis[Z] * axis[Z] + 2.0 * I[X][Y] * axis[X] * axis[Y] +
         2.0 * I[Y][Z] * axis[Y] * axis[Z] + 2.0 * I[Z][X] * axis[Z] * axis[X];
 }
+/*
+ * A triangulated polyhedron keeps its vertices and normals in a body frame
+ * once the geometry parameters are computed, and a moving polyhedron only
+ * updates its pose: the world centroid O and a unit quaternion q that
+ * rotates the body frame about the body centroid Ob. A point pb in the
+ * body frame is at O + R(q)(pb - Ob) in the world frame. Composing unit
+ * quaternions and renormalizing them avoids the drift of repeatedly
+ * rotated vertices, and moving a polyhedron costs O(1) instead of O(V).
+ */
+void MovePolyhedron(const Real offset[restrict], const Real angle[restrict], Polyhedron *poly)
+{
+    /* rotation of this step by the quaternion of the rotation vector */
+    const Real theta = Norm(angle);
+    if (0.0 < theta) {
+        const Real c = cos(0.5 * theta);
+        const Real sn = sin(0.5 * theta) / theta;
+        const Real dq[DIMQ] = {c, sn * angle[X], sn * angle[Y], sn * angle[Z]};
+        const Real q[DIMQ] = {poly->q[0], poly->q[1], poly->q[2], poly->q[3]};
+        poly->q[0] = dq[0] * q[0] - dq[1] * q[1] - dq[2] * q[2] - dq[3] * q[3];
+        poly->q[1] = dq[0] * q[1] + dq[1] * q[0] + dq[2] * q[3] - dq[3] * q[2];
+        poly->q[2] = dq[0] * q[2] - dq[1] * q[3] + dq[2] * q[0] + dq[3] * q[1];
+        poly->q[3] = dq[0] * q[3] + dq[1] * q[2] - dq[2] * q[1] + dq[3] * q[0];
+        Normalize(DIMQ, sqrt(poly->q[0] * poly->q[0] + poly->q[1] * poly->q[1] +
+                    poly->q[2] * poly->q[2] + poly->q[3] * poly->q[3]), poly->q);
+        const Real w = poly->q[0];
+        const Real x = poly->q[1];
+        const Real y = poly->q[2];
+        const Real z = poly->q[3];
+        poly->R[X][X] = 1.0 - 2.0 * (y * y + z * z);
+        poly->R[X][Y] = 2.0 * (x * y - w * z);
+        poly->R[X][Z] = 2.0 * (x * z + w * y);
+        poly->R[Y][X] = 2.0 * (x * y + w * z);
+        poly->R[Y][Y] = 1.0 - 2.0 * (x * x + z * z);
+        poly->R[Y][Z] = 2.0 * (y * z - w * x);
+        poly->R[Z][X] = 2.0 * (x * z - w * y);
+        poly->R[Z][Y] = 2.0 * (y * z + w * x);
+        poly->R[Z][Z] = 1.0 - 2.0 * (x * x + y * y);
+        /* inertia tensor in world frame: R Ib R^T */
+        Real RI[DIMS][DIMS] = {{0.0}};
+        for (int s = 0; s < DIMS; ++s) {
+            for (int m = 0; m < DIMS; ++m) {
+                RI[s][m] = poly->R[s][X] * poly->Ib[X][m] + poly->R[s][Y] * poly->Ib[Y][m] +
+                    poly->R[s][Z] * poly->Ib[Z][m];
+            }
+        }
+        for (int s = 0; s < DIMS; ++s) {
+            for (int m = 0; m < DIMS; ++m) {
+                poly->I[s][m] = Dot(RI[s], poly->R[m]);
+            }
+        }
+    }
+    /* translation of centroid */
+    poly->O[X] = poly->O[X] + offset[X];
+    poly->O[Y] = poly->O[Y] + offset[Y];
+    poly->O[Z] = poly->O[Z] + offset[Z];
+    /* world bounding box enclosing the rotated body bounding box */
+    TransformBox(poly, poly->bvh->box, poly->box);
+    return;
+}
+static int IdentityPose(const Polyhedron *poly)
+{
+    return (1.0 == poly->q[0]) && (0.0 == poly->q[1]) && (0.0 == poly->q[2]) &&
+        (0.0 == poly->q[3]) && (poly->Ob[X] == poly->O[X]) &&
+        (poly->Ob[Y] == poly->O[Y]) && (poly->Ob[Z] == poly->O[Z]);
+}
+void TransformToWorld(const Polyhedron *poly, const Real pb[restrict], Real pw[restrict])
+{
+    if (IdentityPose(poly)) {
+        pw[X] = pb[X];
+        pw[Y] = pb[Y];
+        pw[Z] = pb[Z];
+        return;
+    }
+    const RealVec r = {pb[X] - poly->Ob[X], pb[Y] - poly->Ob[Y], pb[Z] - poly->Ob[Z]};
+    pw[X] = poly->O[X] + Dot(poly->R[X], r);
+    pw[Y] = poly->O[Y] + Dot(poly->R[Y], r);
+    pw[Z] = poly->O[Z] + Dot(poly->R[Z], r);
+    return;
+}
+void TransformBox(const Polyhedron *poly, Real boxb[restrict][LIMIT], Real boxw[restrict][LIMIT])
+{
+    if (IdentityPose(poly)) {
+        for (int s = 0; s < DIMS; ++s) {
+            boxw[s][MIN] = boxb[s][MIN];
+            boxw[s][MAX] = boxb[s][MAX];
+        }
+        return;
+    }
+    RealVec Oc = {0.0}; /* center of body box */
+    RealVec h = {0.0}; /* half extent of body box */
+    RealVec Ow = {0.0}; /* center of world box */
+    for (int s = 0; s < DIMS; ++s) {
+        Oc[s] = 0.5 * (boxb[s][MIN] + boxb[s][MAX]);
+        h[s] = 0.5 * (boxb[s][MAX] - boxb[s][MIN]);
+    }
+    TransformToWorld(poly, Oc, Ow);
+    for (int s = 0; s < DIMS; ++s) {
+        const Real hw = fabs(poly->R[s][X]) * h[X] + fabs(poly->R[s][Y]) * h[Y] +
+            fabs(poly->R[s][Z]) * h[Z];
+        boxw[s][MIN] = Ow[s] - hw;
+        boxw[s][MAX] = Ow[s] + hw;
+    }
+    return;
+}
+void TransformToBody(const Polyhedron *poly, const Real pw[restrict], Real pb[restrict])
+{
+    if (IdentityPose(poly)) {
+        pb[X] = pw[X];
+        pb[Y] = pw[Y];
+        pb[Z] = pw[Z];
+        return;
+    }
+    const RealVec r = {pw[X] - poly->O[X], pw[Y] - poly->O[Y], pw[Z] - poly->O[Z]};
+    for (int s = 0; s < DIMS; ++s) {
+        pb[s] = poly->Ob[s] + poly->R[X][s] * r[X] + poly->R[Y][s] * r[Y] + poly->R[Z][s] * r[Z];
+    }
+    return;
+}
 void ComputeGeometryParameters(const int collapse, Geometry *const geo)
 {
     for (int n = 0; n < geo->sphN; ++n) {
@@ -444,8 +637,176 @@ static void ComputeParametersPolyhedron(const int collapse, Polyhedron *poly)
         }
         Normalize(DIMS, Norm(poly->Ne[n]), poly->Ne[n]);
     }
+    BuildBvh(poly);
+    /* reference pose, the body frame coincides with the world frame */
+    poly->q[0] = 1.0;
+    poly->q[1] = 0.0;
+    poly->q[2] = 0.0;
+    poly->q[3] = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        poly->Ob[s] = poly->O[s];
+        for (int m = 0; m < DIMS; ++m) {
+            poly->R[s][m] = (s == m) ? 1.0 : 0.0;
+            poly->Ib[s][m] = poly->I[s][m];
+        }
+    }
     return;
 }
+/*
+ * An axis-aligned bounding box tree of faces is built by median split on
+ * the face centroids along the longest axis. Child nodes are stored after
+ * their parent, so a reverse sweep refits the tree bottom-up after the
+ * vertices are transformed.
+ */
+static void BuildBvh(Polyhedron *poly)
+{
+    RetrieveStorage(poly->bvh);
+    RetrieveStorage(poly->fo);
+    poly->bvh = AssignStorage(2 * poly->faceN * sizeof(*poly->bvh));
+    poly->fo = AssignStorage(poly->faceN * sizeof(*poly->fo));
+    Real (*Oc)[DIMS] = AssignStorage(poly->faceN * sizeof(*Oc)); /* face centroids */
+    for (int n = 0; n < poly->faceN; ++n) {
+        poly->fo[n] = n;
+        for (int s = 0; s < DIMS; ++s) {
+            Oc[n][s] = (poly->v[poly->f[n][0]][s] + poly->v[poly->f[n][1]][s] + poly->v[poly->f[n][2]][s]) / 3.0;
+        }
+    }
+    poly->bvhN = 1;
+    SplitBvh(0, 0, poly->faceN, Oc, poly);
+    RetrieveStorage(Oc);
+    return;
+}
+static void SplitBvh(const int m, const int fs, const int fn, Real Oc[restrict][DIMS], Polyhedron *poly)
+{
+    Bvh *const node = poly->bvh + m;
+    node->child = 0;
+    node->fs = fs;
+    node->fn = fn;
+    BoundBvh(node, poly);
+    if (BVHL >= fn) {
+        return;
+    }
+    /* split axis with the longest extent of face centroids */
+    Real box[DIMS][LIMIT] = {{0.0}};
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = Oc[poly->fo[fs]][s];
+        box[s][MAX] = Oc[poly->fo[fs]][s];
+    }
+    for (int n = fs + 1; n < fs + fn; ++n) {
+        for (int s = 0; s < DIMS; ++s) {
+            box[s][MIN] = (box[s][MIN] < Oc[poly->fo[n]][s]) ? box[s][MIN] : Oc[poly->fo[n]][s];
+            box[s][MAX] = (box[s][MAX] > Oc[poly->fo[n]][s]) ? box[s][MAX] : Oc[poly->fo[n]][s];
+        }
+    }
+    int axis = X;
+    for (int s = Y; s < DIMS; ++s) {
+        if ((box[s][MAX] - box[s][MIN]) > (box[axis][MAX] - box[axis][MIN])) {
+            axis = s;
+        }
+    }
+    SelectFace(fn / 2, fn, axis, Oc, poly->fo + fs);
+    node->child = poly->bvhN;
+    poly->bvhN = poly->bvhN + 2;
+    SplitBvh(node->child, fs, fn / 2, Oc, poly);
+    SplitBvh(node->child + 1, fs + fn / 2, fn - fn / 2, Oc, poly);
+    return;
+}
+/*
+ * Partially order the face list fo of length n by centroid coordinate on
+ * axis s, such that the k-th face is in place, faces before it are not
+ * greater, and faces after it are not less.
+ */
+static void SelectFace(const int k, const int n, const int s, Real Oc[restrict][DIMS], int fo[restrict])
+{
+    int temp = 0;
+    Real v = 0.0;
+    for (int l = 0, r = n - 1; l < r;) {
+        v = Oc[fo[(l + r) / 2]][s];
+        int i = l;
+        int j = r;
+        while (i <= j) {
+            while (Oc[fo[i]][s] < v) {
+                ++i;
+            }
+            while (Oc[fo[j]][s] > v) {
+                --j;
+            }
+            if (i <= j) {
+                temp = fo[i];
+                fo[i] = fo[j];
+                fo[j] = temp;
+                ++i;
+                --j;
+            }
+        }
+        if (k <= j) {
+            r = j;
+        } else {
+            if (k >= i) {
+                l = i;
+            } else {
+                return;
+            }
+        }
+    }
+    return;
+}
+static void BoundBvh(Bvh *node, const Polyhedron *poly)
+{
+    const int *v = poly->f[poly->fo[node->fs]];
+    for (int s = 0; s < DIMS; ++s) {
+        node->box[s][MIN] = poly->v[v[0]][s];
+        node->box[s][MAX] = poly->v[v[0]][s];
+    }
+    for (int n = node->fs; n < node->fs + node->fn; ++n) {
+        v = poly->f[poly->fo[n]];
+        for (int t = 0; t < POLYN; ++t) {
+            for (int s = 0; s < DIMS; ++s) {
+                node->box[s][MIN] = (node->box[s][MIN] < poly->v[v[t]][s]) ? node->box[s][MIN] : poly->v[v[t]][s];
+                node->box[s][MAX] = (node->box[s][MAX] > poly->v[v[t]][s]) ? node->box[s][MAX] : poly->v[v[t]][s];
+            }
+        }
+    }
+    return;
+}
+static void RefitBvh(Polyhedron *poly)
+{
+    Bvh *node = NULL;
+    const Bvh *cl = NULL; /* child nodes */
+    const Bvh *cr = NULL;
+    for (int m = poly->bvhN - 1; m >= 0; --m) {
+        node = poly->bvh + m;
+        if (0 == node->child) {
+            BoundBvh(node, poly);
+            continue;
+        }
+        cl = poly->bvh + node->child;
+        cr = poly->bvh + node->child + 1;
+        for (int s = 0; s < DIMS; ++s) {
+            node->box[s][MIN] = MinReal(cl->box[s][MIN], cr->box[s][MIN]);
+            node->box[s][MAX] = MaxReal(cl->box[s][MAX], cr->box[s][MAX]);
+        }
+    }
+    return;
+}
+static Real PointBoxDistance(const Real p[restrict], const Real box[restrict][LIMIT])
+{
+    Real dist = 0.0;
+    Real distSquare = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        if (p[s] < box[s][MIN]) {
+            dist = box[s][MIN] - p[s];
+        } else {
+            if (p[s] > box[s][MAX]) {
+                dist = p[s] - box[s][MAX];
+            } else {
+                dist = 0.0;
+            }
+        }
+        distSquare = distSquare + dist * dist;
+    }
+    return distSquare;
+}
 void BuildTriangle(const int fid, const Polyhedron *poly, Real v0[restrict],
         Real v1[restrict], Real v2[restrict], Real e01[restrict], Real e02[restrict])
 {
@@ -470,6 +831,7 @@ int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[re
     RealVec e02 = {zero};
     RealVec pi = {zero}; /* closest point */
     RealVec N = {zero}; /* normal of the closest point */
+    RealVec pb = {zero}; /* point in body frame */
     /*
      * Parametric equation of triangle defined plane
      * T(s,t) = v0 + s(v1-v0) + t(v2-v0) = v0 + s*e01 + t*e02
@@ -483,19 +845,57 @@ int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[re
     Real distSquare = zero; /* store computed squared distance */
     Real distSquareMin = FLT_MAX; /* store minimum squared distance */
     int cid = 0; /* closest face identifier */
-    for (int n = 0; n < poly->faceN; ++n) {
-        BuildTriangle(n, poly, v0, v1, v2, e01, e02);
-        distSquare = PointTriangleDistance(p, v0, e01, e02, para);
-        if (distSquareMin > distSquare) {
-            distSquareMin = distSquare;
-            cid = n;
+    /*
+     * Traverse the bounding volume hierarchy with the nearer child first,
+     * and prune nodes farther than the closest face found so far. A small
+     * tolerance on pruning keeps faces whose round-off distance may tie
+     * the minimum, and ties resolve to the lowest face identifier, which
+     * finds the same face as an exhaustive search.
+     */
+    TransformToBody(poly, p, pb);
+    const Bvh *node = poly->bvh;
+    const Bvh *cl = NULL; /* child nodes */
+    const Bvh *cr = NULL;
+    const RealVec extent = {node->box[X][MAX] - node->box[X][MIN],
+        node->box[Y][MAX] - node->box[Y][MIN], node->box[Z][MAX] - node->box[Z][MIN]};
+    const Real tol = FLT_EPSILON * Dot(extent, extent); /* pruning tolerance */
+    int stack[BVHS] = {0}; /* traversal stack */
+    int top = 1; /* stack pointer */
+    int n = 0; /* face identifier */
+    while (0 < top) {
+        --top;
+        node = poly->bvh + stack[top];
+        if (PointBoxDistance(pb, node->box) > distSquareMin + tol) {
+            continue;
+        }
+        if (0 == node->child) { /* leaf node */
+            for (int m = node->fs; m < node->fs + node->fn; ++m) {
+                n = poly->fo[m];
+                BuildTriangle(n, poly, v0, v1, v2, e01, e02);
+                distSquare = PointTriangleDistance(pb, v0, e01, e02, para);
+                if ((distSquareMin > distSquare) || ((distSquareMin == distSquare) && (cid > n))) {
+                    distSquareMin = distSquare;
+                    cid = n;
+                }
+            }
+            continue;
+        }
+        cl = poly->bvh + node->child;
+        cr = poly->bvh + node->child + 1;
+        if (PointBoxDistance(pb, cl->box) > PointBoxDistance(pb, cr->box)) {
+            stack[top] = node->child;
+            stack[top+1] = node->child + 1;
+        } else {
+            stack[top] = node->child + 1;
+            stack[top+1] = node->child;
         }
+        top = top + 2;
     }
     *fid = cid;
-    ComputeIntersection(p, cid, poly, pi, N);
-    pi[X] = p[X] - pi[X];
-    pi[Y] = p[Y] - pi[Y];
-    pi[Z] = p[Z] - pi[Z];
+    IntersectFace(pb, cid, poly, pi, N);
+    pi[X] = pb[X] - pi[X];
+    pi[Y] = pb[Y] - pi[Y];
+    pi[Z] = pb[Z] - pi[Z];
     if (zero < Dot(pi, N)) {
         /* outside polyhedron */
         return 0;
@@ -688,6 +1088,23 @@ Real PointTriangleDistance(const Real p[restrict], const Real v0[restrict], cons
 }
 Real ComputeIntersection(const Real p[restrict], const int fid,
         const Polyhedron *poly, Real pi[restrict], Real N[restrict])
+{
+    if (IdentityPose(poly)) {
+        return IntersectFace(p, fid, poly, pi, N);
+    }
+    RealVec pb = {0.0}; /* point in body frame */
+    RealVec pib = {0.0}; /* intersection point in body frame */
+    RealVec Nb = {0.0}; /* normal in body frame */
+    TransformToBody(poly, p, pb);
+    const Real distSquare = IntersectFace(pb, fid, poly, pib, Nb);
+    TransformToWorld(poly, pib, pi);
+    N[X] = Dot(poly->R[X], Nb);
+    N[Y] = Dot(poly->R[Y], Nb);
+    N[Z] = Dot(poly->R[Z], Nb);
+    return distSquare;
+}
+static Real IntersectFace(const Real p[restrict], const int fid,
+        const Polyhedron *poly, Real pi[restrict], Real N[restrict])
 {
     const Real zero = 0.0;
     const Real one = 1.0;
@@ -28,12 +28,14 @@
  *
  * Function
  *      Convert polyhedron representation from STL to a mixture form
- *      of face-vertex mesh and winged-edge mesh.
+ *      of face-vertex mesh and winged-edge mesh. Vertices are welded and
+ *      edges are paired through hash tables, then edges are sorted for
+ *      the binary search of edge lookup.
  */
 extern void ConvertPolyhedron(Polyhedron *);
 extern void AllocatePolyhedronMemory(const int vertN, const int edgeN,
         const int faceN, Polyhedron *);
-extern void AddEdge(const int v0, const int v1, const int f, Polyhedron *);
+extern void BuildEdgeList(Polyhedron *);
 extern void QuickSortEdge(const int n, int e[restrict][EVF]);
 extern void BuildTriangle(const int fid, const Polyhedron *, Real v0[restrict],
         Real v1[restrict], Real v2[restrict], Real e01[restrict], Real e02[restrict]);
@@ -49,9 +51,40 @@ extern void BuildTriangle(const int fid, const Polyhedron *, Real v0[restrict],
 extern void ComputeGeometryParameters(const int collapse, Geometry *const);
 /*
  * Polyhedron transformation
+ *
+ * Function
+ *      Rewrite the reference geometry of a polyhedron by scaling, rotation,
+ *      and translation, which is used to place a polyhedron initially.
  */
 extern void TransformPolyhedron(const Real O[restrict], const Real scale[restrict],
         const Real angle[restrict], const Real offset[restrict], Polyhedron *);
+/*
+ * Polyhedron motion
+ *
+ * Function
+ *      Move a triangulated polyhedron by updating its pose, a centroid
+ *      position plus a unit quaternion orientation, while vertices and
+ *      normals stay in the body frame. The world bounding box and inertia
+ *      tensor are updated accordingly.
+ */
+extern void MovePolyhedron(const Real offset[restrict], const Real angle[restrict], Polyhedron *);
+/*
+ * Pose transformation
+ *
+ * Function
+ *      Transform a point between the world frame and the body frame of a
+ *      triangulated polyhedron.
+ */
+extern void TransformToWorld(const Polyhedron *, const Real pb[restrict], Real pw[restrict]);
+extern void TransformToBody(const Polyhedron *, const Real pw[restrict], Real pb[restrict]);
+/*
+ * Box transformation
+ *
+ * Function
+ *      Find a world frame axis-aligned box that encloses a body frame box
+ *      of a triangulated polyhedron.
+ */
+extern void TransformBox(const Polyhedron *, Real boxb[restrict][LIMIT], Real boxw[restrict][LIMIT]);
 /*
  * Point in polyhedron
  *
@@ -26,34 +26,49 @@ typedef enum {
  * Function Pointers
  ****************************************************************************/
 typedef void (*FhatReconstructor)(Real [restrict][DIMU], Real [restrict]);
+typedef void (*FhatBatchReconstructor)(Real [restrict][DIMU][BATCHN],
+        Real [restrict][BATCHN]);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void CharacteristicVariable(const int, const int, const int, const int,
-        const int, const int, const int, const int [restrict], const Node *const,
+        const int, const int [restrict], const Node *const,
         Real [restrict][DIMU], Real [restrict][DIMU]);
 static void CharacteristicFlux(const Real [restrict], Real [restrict][DIMU],
         const int, const int, const int,  Real [restrict][DIMU]);
 static void InverseProjection(Real [restrict][DIMU], const Real [restrict],
         const Real [restrict], Real [restrict]);
+#ifndef ARTRACFD_SCALAR_FHAT
+static void ComputeFhatBatch(const int, const int, const int, const int,
+        const int [restrict], const Node *const, const Model *,
+        Real [restrict][DIMU]);
+#endif
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
 static FhatReconstructor ReconstructFhat[2] = {
     WENO3,
     WENO5};
+#ifndef ARTRACFD_SCALAR_FHAT
+static FhatBatchReconstructor ReconstructFhatBatch[2] = {
+    WENO3Batch,
+    WENO5Batch};
+#endif
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-void ComputeFhat(const int tn, const int s, const int k, const int j, const int i,
-        const int partn[restrict], const Node *const node, const Model *model, Real Fhat[restrict])
+void ComputeFhat(const int tn, const int s, const int idx, const int stride[restrict],
+        const Node *const node, const Model *model, Real Fhat[restrict])
 {
-    const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    const int idxL = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxR = IndexNode(k + h[s][Z], j + h[s][Y], i + h[s][X], partn[Y], partn[X]);
+    const int idxL = idx;
+    const int idxR = idx + stride[s];
     /* evaluate interface values by averaging */
+    Real UL[DIMU]; /* left state */
+    Real UR[DIMU]; /* right state */
     Real Uo[DIMUo]; /* store averaged primitives */
-    SymmetricAverage(model->jacobMean, model->gamma, node[idxL].U[tn], node[idxR].U[tn], Uo);
+    LoadU(tn, idxL, node, UL);
+    LoadU(tn, idxR, node, UR);
+    SymmetricAverage(model->jacobMean, model->gamma, UL, UR, Uo);
     /* decompose Jacobian matrix */
     Real Lambda[DIMU]; /* eigenvalues */
     Real L[DIMU][DIMU]; /* vector space {Ln} */
@@ -67,7 +82,7 @@ void ComputeFhat(const int tn, const int s, const int k, const int j, const int
     EigenvalueSplitting(model->fluxSplit, Lambda, LambdaP, LambdaN);
     /* construct local characteristic variables for all potential stencils */
     Real W[FTN][DIMU];
-    CharacteristicVariable(tn, s, k, j, i, model->sL, model->sR, partn, node, L, W);
+    CharacteristicVariable(tn, s, idx, model->sL, model->sR, stride, node, L, W);
     /* construct local characteristic fluxes */
     Real HP[FDN][DIMU]; /* forward characteristic flux stencil */
     Real HN[FDN][DIMU]; /* backward characteristic flux stencil */
@@ -82,16 +97,13 @@ void ComputeFhat(const int tn, const int s, const int k, const int j, const int
     InverseProjection(R, HhatP, HhatN, Fhat);
     return;
 }
-static void CharacteristicVariable(const int tn, const int s, const int k, const int j,
-        const int i, const int sL, const int sR, const int partn[restrict],
+static void CharacteristicVariable(const int tn, const int s, const int idx,
+        const int sL, const int sR, const int stride[restrict],
         const Node *const node, Real L[restrict][DIMU], Real W[restrict][DIMU])
 {
-    const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    int idx = 0; /* linear array index math variable */
-    const Real *restrict U = NULL;
+    Real U[DIMU] = {0.0};
     for (int n = sL, m = 0; n <= sR; ++n, ++m) {
-        idx = IndexNode(k + n * h[s][Z], j + n * h[s][Y], i + n * h[s][X], partn[Y], partn[X]);
-        U = node[idx].U[tn];
+        LoadU(tn, idx + n * stride[s], node, U);
         for (int r = 0; r < DIMU; ++r) {
             W[m][r] = 0.0;
             for (int c = 0; c < DIMU; ++c) {
@@ -122,5 +134,106 @@ static void InverseProjection(Real R[restrict][DIMU], const Real HhatP[restrict]
     }
     return;
 }
+void ComputeFhatLine(const int tn, const int s, const int idx, const int N,
+        const int stride[restrict], const Node *const node,
+        const Model *model, Real Fhat[restrict][DIMU])
+{
+#ifdef ARTRACFD_SCALAR_FHAT
+    for (int m = 0; m < N; ++m) {
+        ComputeFhat(tn, s, idx + m * stride[s], stride, node, model, Fhat[m]);
+    }
+#else
+    for (int m = 0; m < N; m = m + BATCHN) {
+        ComputeFhatBatch(tn, s, idx + m * stride[s], MinInt(BATCHN, N - m),
+                stride, node, model, Fhat + m);
+    }
+#endif
+    return;
+}
+#ifndef ARTRACFD_SCALAR_FHAT
+/*
+ * Batched counterpart of ComputeFhat for bn <= BATCHN interfaces. The bn
+ * interfaces share bn + sR - sL stencil nodes, which are loaded once. All
+ * BATCHN lanes are always computed to give fixed trip counts to the vector
+ * loops; lanes beyond bn repeat the last stencil node and are discarded.
+ */
+static void ComputeFhatBatch(const int tn, const int s, const int idx, const int bn,
+        const int stride[restrict], const Node *const node,
+        const Model *model, Real Fhat[restrict][DIMU])
+{
+    const int tot = model->sR - model->sL; /* stencil width minus one */
+    /* load stencil nodes, the one of interface b and offset n is b + n */
+    Real U[DIMU][BATCHN+FTN-1];
+    for (int r = 0; r < DIMU; ++r) {
+        const Real *restrict Uf = node->U[tn][r] + idx + model->sL * stride[s];
+        for (int b = 0; b < BATCHN + tot; ++b) {
+            U[r][b] = Uf[MinInt(b, bn + tot - 1) * stride[s]];
+        }
+    }
+    /* evaluate interface values by averaging */
+    Real UL[DIMU][BATCHN]; /* left state */
+    Real UR[DIMU][BATCHN]; /* right state */
+    Real Uo[DIMUo][BATCHN]; /* store averaged primitives */
+    for (int r = 0; r < DIMU; ++r) {
+        for (int b = 0; b < BATCHN; ++b) {
+            UL[r][b] = U[r][b-model->sL];
+            UR[r][b] = U[r][b-model->sL+1];
+        }
+    }
+    SymmetricAverageBatch(model->jacobMean, model->gamma, UL, UR, Uo);
+    /* decompose Jacobian matrix and split eigenvalues */
+    Real L[DIMU][DIMU][BATCHN]; /* vector space {Ln} */
+    Real R[DIMU][DIMU][BATCHN]; /* vector space {Rn} */
+    Real LambdaP[DIMU][BATCHN]; /* eigenvalues */
+    Real LambdaN[DIMU][BATCHN]; /* eigenvalues */
+    EigenvectorLBatch(s, model->gamma, Uo, L);
+    EigenvectorRBatch(s, Uo, R);
+    EigenvalueSplittingBatch(s, model->fluxSplit, Uo, LambdaP, LambdaN);
+    /* construct local characteristic variables and fluxes */
+    Real W[FTN][DIMU][BATCHN];
+    Real HP[FDN][DIMU][BATCHN]; /* forward characteristic flux stencil */
+    Real HN[FDN][DIMU][BATCHN]; /* backward characteristic flux stencil */
+    for (int m = 0; m <= tot; ++m) {
+        for (int r = 0; r < DIMU; ++r) {
+            for (int b = 0; b < BATCHN; ++b) {
+                Real w = 0.0;
+                for (int c = 0; c < DIMU; ++c) {
+                    w = w + L[r][c][b] * U[c][b+m];
+                }
+                W[m][r][b] = w;
+            }
+        }
+    }
+    for (int m = 0; m < tot; ++m) {
+        for (int r = 0; r < DIMU; ++r) {
+            for (int b = 0; b < BATCHN; ++b) {
+                HP[m][r][b] = LambdaP[r][b] * W[m][r][b];
+                HN[m][r][b] = LambdaN[r][b] * W[tot-m][r][b];
+            }
+        }
+    }
+    /* WENO reconstruction */
+    Real HhatP[DIMU][BATCHN]; /* forward numerical flux of characteristic fields */
+    Real HhatN[DIMU][BATCHN]; /* backward numerical flux of characteristic fields */
+    ReconstructFhatBatch[model->sScheme](HP, HhatP);
+    ReconstructFhatBatch[model->sScheme](HN, HhatN);
+    /* inverse projection */
+    Real F[DIMU][BATCHN];
+    for (int r = 0; r < DIMU; ++r) {
+        for (int b = 0; b < BATCHN; ++b) {
+            F[r][b] = 0.0;
+            for (int c = 0; c < DIMU; ++c) {
+                F[r][b] = F[r][b] + R[r][c][b] * (HhatP[c][b] + HhatN[c][b]);
+            }
+        }
+    }
+    for (int b = 0; b < bn; ++b) {
+        for (int r = 0; r < DIMU; ++r) {
+            Fhat[b][r] = F[r][b];
+        }
+    }
+    return;
+}
+#endif
 /* a good practice: end file with a newline */
 
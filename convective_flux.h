@@ -27,11 +27,28 @@
  * Convective flux
  *
  * Function
- *      reconstruct the numerical convective flux.
+ *      reconstruct the numerical convective flux at the interface between
+ *      node idx and its neighbour in direction s. Stencil nodes are
+ *      addressed by the index stride of each dimension.
  */
-extern void ComputeFhat(const int tn, const int s, const int k, const int j,
-        const int i, const int partn[restrict], const Node *const,
+extern void ComputeFhat(const int tn, const int s, const int idx,
+        const int stride[restrict], const Node *const,
         const Model *, Real Fhat[restrict]);
+/*
+ * Convective flux of a line
+ *
+ * Function
+ *      reconstruct the numerical convective flux at N consecutive interfaces
+ *      in direction s, the first one being the interface between node idx
+ *      and its neighbour. Interfaces are processed in batches laid out with
+ *      the interface as the fastest index, so the averaging, decomposition,
+ *      projection and WENO loops vectorize across interfaces. Compiling
+ *      with -DARTRACFD_SCALAR_FHAT reverts to calling ComputeFhat for each
+ *      interface, which is the reference implementation.
+ */
+extern void ComputeFhatLine(const int tn, const int s, const int idx, const int N,
+        const int stride[restrict], const Node *const,
+        const Model *, Real Fhat[restrict][DIMU]);
 #endif
 /* a good practice: end file with a newline */
 
@@ -0,0 +1,472 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "data_exchange.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#ifdef ARTRACFD_MPI
+#include <mpi.h> /* message passing interface */
+#endif
+#include "cfd_commons.h"
+#include "commons.h"
+#ifdef ARTRACFD_MPI
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    EXFIELD = 0, /* exchange field data */
+    EXDOMAIN = 1, /* exchange geometric field data */
+    EXFLAG = 4, /* number of geometric field flags */
+    EXCOL = 7, /* collision entry: gid, N, key */
+} ExchangeConst;
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void ExchangeNodeData(const int, const int, Space *);
+static void PackNodeData(const int, const int, int [restrict][LIMIT],
+        const Partition *const, const Node *const, unsigned char *);
+static void UnpackNodeData(const int, const int, int [restrict][LIMIT],
+        const Partition *const, Node *const, const unsigned char *);
+static MPI_Datatype RealType(void);
+static int CompareKey(const int [restrict], const int [restrict]);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static MPI_Comm comm = MPI_COMM_NULL; /* Cartesian communicator */
+static int rankN = 1; /* number of processors */
+static size_t bufN = 0; /* size of message buffers */
+static unsigned char *sbuf = NULL; /* send buffer */
+static unsigned char *rbuf = NULL; /* receive buffer */
+#endif
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+void InitializeDataExchange(Partition *part)
+{
+#ifdef ARTRACFD_MPI
+    int level = MPI_THREAD_SINGLE; /* only the main thread makes MPI calls */
+    MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &level);
+    MPI_Comm_rank(MPI_COMM_WORLD, &(part->rank));
+    if ((MPI_THREAD_FUNNELED > level) && (0 == part->rank)) {
+        ShowWarning("mpi library is not thread safe for the background data writer\n");
+    }
+    MPI_Comm_size(MPI_COMM_WORLD, &(part->rankN));
+    rankN = part->rankN;
+    if (part->procN != part->rankN) {
+        ShowError("number of processes %d mismatches nx*ny*nz = %d\n", part->rankN, part->procN);
+    }
+    if (0 != part->rank) { /* only the root processor reports progress */
+        if (NULL == freopen("/dev/null", "w", stdout)) {
+            ShowWarning("standard output of processor %d not silenced\n", part->rank);
+        }
+    }
+#else
+    (void)part;
+    ShowError("mpi mode requires compiling with CC=mpicc\n");
+#endif
+    return;
+}
+void FinalizeDataExchange(void)
+{
+#ifdef ARTRACFD_MPI
+    int flag = 0;
+    MPI_Initialized(&flag);
+    if (!flag) {
+        return;
+    }
+    RetrieveStorage(sbuf);
+    RetrieveStorage(rbuf);
+    if (MPI_COMM_NULL != comm) {
+        MPI_Comm_free(&comm);
+    }
+    MPI_Finalize();
+#endif
+    return;
+}
+void CreateExchangeTopology(Partition *part)
+{
+    for (int p = 0; p < NBC; ++p) {
+        part->nb[p] = NONE;
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        part->coord[s] = 0;
+    }
+#ifdef ARTRACFD_MPI
+    if (1 >= part->rankN) {
+        return;
+    }
+    int periods[DIMS] = {0};
+    int nl = 0, nh = 0; /* neighbours at lower and higher side */
+    for (int s = 0, p = PWB; s < DIMS; ++s, p = p + 2) {
+        /* periodic boundary within a single block is treated by boundary condition */
+        periods[s] = (PERIODIC == part->typeBC[p]) && (1 < part->proc[s]);
+    }
+    MPI_Cart_create(MPI_COMM_WORLD, DIMS, part->proc, periods, 0, &comm);
+    MPI_Comm_rank(comm, &(part->rank));
+    MPI_Cart_coords(comm, part->rank, DIMS, part->coord);
+    for (int s = 0, p = PWB; s < DIMS; ++s, p = p + 2) {
+        MPI_Cart_shift(comm, s, 1, &nl, &nh);
+        if (MPI_PROC_NULL != nl) {
+            part->nb[p] = nl;
+        }
+        if (MPI_PROC_NULL != nh) {
+            part->nb[p + 1] = nh;
+        }
+    }
+#endif
+    return;
+}
+void ExchangeFieldData(const int tn, Space *space)
+{
+#ifdef ARTRACFD_MPI
+    ExchangeNodeData(EXFIELD, tn, space);
+#else
+    (void)tn;
+    (void)space;
+#endif
+    return;
+}
+void ExchangeDomainField(Space *space)
+{
+#ifdef ARTRACFD_MPI
+    ExchangeNodeData(EXDOMAIN, TO, space);
+#else
+    (void)space;
+#endif
+    return;
+}
+void ReduceMaxReal(const int n, Real v[])
+{
+#ifdef ARTRACFD_MPI
+    if (1 >= rankN) {
+        return;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, v, n, RealType(), MPI_MAX, comm);
+#else
+    (void)n;
+    (void)v;
+#endif
+    return;
+}
+/*
+ * The force sums and interfacial node counts are summed up. The pressure
+ * statistics of each processor are shifted by different offsets, hence they
+ * are converted into mean and sum of squared deviations, then merged in
+ * processor order by the pairwise update of Chan et al. The result is
+ * stored as a zero offset sum with the mean as the offset.
+ */
+void ReduceSurfaceForce(Real (*stat)[FCN], Geometry *const geo)
+{
+#ifdef ARTRACFD_MPI
+    if ((1 >= rankN) || (0 == geo->totN)) {
+        return;
+    }
+    const int sumN = 3 * DIMS + 2; /* Fp, Fv, Tt, lidN, gstN */
+    const int varN = 3; /* gstN, mean, sum of squared deviations */
+    const Real zero = 0.0;
+    Polyhedron *poly = NULL;
+    Real *sum = AssignStorage(geo->totN * sumN * sizeof(*sum));
+    Real *var = AssignStorage(geo->totN * varN * sizeof(*var));
+    Real *varAll = AssignStorage(rankN * geo->totN * varN * sizeof(*varAll));
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        for (int s = 0; s < DIMS; ++s) {
+            sum[n * sumN + s] = poly->Fp[s];
+            sum[n * sumN + DIMS + s] = poly->Fv[s];
+            sum[n * sumN + 2 * DIMS + s] = poly->Tt[s];
+        }
+        sum[n * sumN + 3 * DIMS] = stat[n][0];
+        sum[n * sumN + 3 * DIMS + 1] = stat[n][1];
+        var[n * varN] = stat[n][1];
+        if (zero < stat[n][1]) {
+            var[n * varN + 1] = stat[n][3] / stat[n][1] + stat[n][2];
+            var[n * varN + 2] = stat[n][4] - stat[n][3] * stat[n][3] / stat[n][1];
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, sum, geo->totN * sumN, RealType(), MPI_SUM, comm);
+    MPI_Allgather(var, geo->totN * varN, RealType(), varAll, geo->totN * varN, RealType(), comm);
+    Real cnt = zero, mean = zero, m2 = zero, delta = zero; /* merged statistics */
+    const Real *vr = NULL;
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        for (int s = 0; s < DIMS; ++s) {
+            poly->Fp[s] = sum[n * sumN + s];
+            poly->Fv[s] = sum[n * sumN + DIMS + s];
+            poly->Tt[s] = sum[n * sumN + 2 * DIMS + s];
+        }
+        cnt = zero; mean = zero; m2 = zero;
+        for (int r = 0; r < rankN; ++r) {
+            vr = varAll + (r * geo->totN + n) * varN;
+            if (zero >= vr[0]) {
+                continue;
+            }
+            delta = vr[1] - mean;
+            mean = mean + delta * vr[0] / (cnt + vr[0]);
+            m2 = m2 + vr[2] + delta * delta * cnt * vr[0] / (cnt + vr[0]);
+            cnt = cnt + vr[0];
+        }
+        stat[n][0] = sum[n * sumN + 3 * DIMS];
+        stat[n][1] = sum[n * sumN + 3 * DIMS + 1];
+        stat[n][2] = mean;
+        stat[n][3] = zero;
+        stat[n][4] = m2;
+    }
+    RetrieveStorage(sum);
+    RetrieveStorage(var);
+    RetrieveStorage(varAll);
+#else
+    (void)stat;
+    (void)geo;
+#endif
+    return;
+}
+/*
+ * Each processor detects the colliding objects at its own nodes in the
+ * ascending global node order. A k-way merge by the first detection node
+ * recovers the colliding list of a single processor scanning the whole
+ * domain, which keeps the order-dependent collision response identical.
+ */
+void ReduceCollision(Geometry *const geo)
+{
+#ifdef ARTRACFD_MPI
+    if (1 >= rankN) {
+        return;
+    }
+    int *cnt = AssignStorage(2 * rankN * sizeof(*cnt));
+    int *disp = cnt + rankN;
+    int *loc = AssignStorage((geo->colN * EXCOL + 1) * sizeof(*loc));
+    Collision *col = NULL;
+    for (int n = 0; n < geo->colN; ++n) {
+        col = geo->col + n;
+        loc[n * EXCOL] = col->gid;
+        for (int s = 0; s < DIMS; ++s) {
+            loc[n * EXCOL + 1 + s] = col->N[s];
+            loc[n * EXCOL + 1 + DIMS + s] = col->key[s];
+        }
+    }
+    const int locN = geo->colN * EXCOL;
+    MPI_Allgather(&locN, 1, MPI_INT, cnt, 1, MPI_INT, comm);
+    int allN = 0;
+    for (int r = 0; r < rankN; ++r) {
+        disp[r] = allN;
+        allN = allN + cnt[r];
+    }
+    int *all = AssignStorage((allN + 1) * sizeof(*all));
+    MPI_Allgatherv(loc, locN, MPI_INT, all, cnt, disp, MPI_INT, comm);
+    /* k-way merge by the first detection node */
+    int *head = AssignStorage(rankN * sizeof(*head));
+    const int *entry = NULL;
+    int pick = NONE;
+    int m = 0;
+    geo->colN = 0;
+    while (1) {
+        pick = NONE;
+        for (int r = 0; r < rankN; ++r) {
+            if (head[r] >= cnt[r]) {
+                continue;
+            }
+            if ((NONE == pick) || (0 > CompareKey(all + disp[r] + head[r] + 1 + DIMS,
+                            all + disp[pick] + head[pick] + 1 + DIMS))) {
+                pick = r;
+            }
+        }
+        if (NONE == pick) {
+            break;
+        }
+        entry = all + disp[pick] + head[pick];
+        head[pick] = head[pick] + EXCOL;
+        for (m = 0; m < geo->colN; ++m) {
+            if (entry[0] == geo->col[m].gid) {
+                break;
+            }
+        }
+        col = geo->col + m;
+        if (m == geo->colN) { /* a new object */
+            col->gid = entry[0];
+            memset(col->N, 0, DIMS * sizeof(*col->N));
+            for (int s = 0; s < DIMS; ++s) {
+                col->key[s] = entry[1 + DIMS + s];
+            }
+            ++(geo->colN);
+        }
+        for (int s = 0; s < DIMS; ++s) {
+            col->N[s] = col->N[s] + entry[1 + s];
+        }
+    }
+    RetrieveStorage(cnt);
+    RetrieveStorage(loc);
+    RetrieveStorage(all);
+    RetrieveStorage(head);
+#else
+    (void)geo;
+#endif
+    return;
+}
+#ifdef ARTRACFD_MPI
+/*
+ * Ghost layers shared with neighbouring blocks are filled direction by
+ * direction. Each slab covers the entire range of the other directions,
+ * hence edge and corner ghost nodes are relayed by the later directions.
+ * For a periodic direction distributed over processors, the first and last
+ * node layers coincide, therefore, the wrapped slab skips the duplicated
+ * layer to reproduce the periodic boundary condition.
+ */
+static void ExchangeNodeData(const int type, const int tn, Space *space)
+{
+    const Partition *const part = &(space->part);
+    Node *const node = space->node;
+    if (1 >= part->rankN) {
+        return;
+    }
+    const size_t size = (EXFIELD == type) ? DIMU * sizeof(Real) : EXFLAG * sizeof(int);
+    int sbox[DIMS][LIMIT] = {{0}}; /* range box of sending slab */
+    int rbox[DIMS][LIMIT] = {{0}}; /* range box of receiving slab */
+    int dest = MPI_PROC_NULL, src = MPI_PROC_NULL;
+    int shift = 0; /* skip duplicated periodic layer */
+    int count = 0;
+    if (0 == bufN) {
+        for (int s = 0; s < DIMS; ++s) {
+            count = MaxInt(count, part->ng[s] * part->n[X] * part->n[Y] * part->n[Z] / part->n[s]);
+        }
+        bufN = count * DIMU * sizeof(Real);
+        sbuf = AssignStorage(bufN);
+        rbuf = AssignStorage(bufN);
+    }
+    for (int s = 0, p = PWB; s < DIMS; ++s, p = p + 2) {
+        if (1 == part->proc[s]) {
+            continue;
+        }
+        for (int r = 0; r < DIMS; ++r) {
+            sbox[r][MIN] = 0;
+            sbox[r][MAX] = part->n[r];
+            rbox[r][MIN] = 0;
+            rbox[r][MAX] = part->n[r];
+        }
+        count = part->ng[s] * part->n[X] * part->n[Y] * part->n[Z] / part->n[s];
+        /* send lower slab to lower neighbour, receive upper ghost from upper neighbour */
+        shift = (0 == part->coord[s]);
+        sbox[s][MIN] = part->ng[s] + shift;
+        sbox[s][MAX] = 2 * part->ng[s] + shift;
+        rbox[s][MIN] = part->n[s] - part->ng[s];
+        rbox[s][MAX] = part->n[s];
+        dest = (NONE == part->nb[p]) ? MPI_PROC_NULL : part->nb[p];
+        src = (NONE == part->nb[p + 1]) ? MPI_PROC_NULL : part->nb[p + 1];
+        if (MPI_PROC_NULL != dest) {
+            PackNodeData(type, tn, sbox, part, node, sbuf);
+        }
+        MPI_Sendrecv(sbuf, count * size, MPI_BYTE, dest, 0, rbuf, count * size, MPI_BYTE, src, 0,
+                comm, MPI_STATUS_IGNORE);
+        if (MPI_PROC_NULL != src) {
+            UnpackNodeData(type, tn, rbox, part, node, rbuf);
+        }
+        /* send upper slab to upper neighbour, receive lower ghost from lower neighbour */
+        shift = (part->proc[s] - 1 == part->coord[s]);
+        sbox[s][MIN] = part->n[s] - 2 * part->ng[s] - shift;
+        sbox[s][MAX] = part->n[s] - part->ng[s] - shift;
+        rbox[s][MIN] = 0;
+        rbox[s][MAX] = part->ng[s];
+        dest = (NONE == part->nb[p + 1]) ? MPI_PROC_NULL : part->nb[p + 1];
+        src = (NONE == part->nb[p]) ? MPI_PROC_NULL : part->nb[p];
+        if (MPI_PROC_NULL != dest) {
+            PackNodeData(type, tn, sbox, part, node, sbuf);
+        }
+        MPI_Sendrecv(sbuf, count * size, MPI_BYTE, dest, 1, rbuf, count * size, MPI_BYTE, src, 1,
+                comm, MPI_STATUS_IGNORE);
+        if (MPI_PROC_NULL != src) {
+            UnpackNodeData(type, tn, rbox, part, node, rbuf);
+        }
+    }
+    return;
+}
+static void PackNodeData(const int type, const int tn, int box[restrict][LIMIT],
+        const Partition *const part, const Node *const node, unsigned char *buf)
+{
+    int idx = 0; /* linear array index math variable */
+    int flag[EXFLAG] = {0};
+    Real U[DIMU] = {0.0};
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                switch (type) {
+                    case EXFIELD:
+                        LoadU(tn, idx, node, U);
+                        memcpy(buf, U, DIMU * sizeof(Real));
+                        buf = buf + DIMU * sizeof(Real);
+                        break;
+                    default:
+                        flag[0] = node->did[idx];
+                        flag[1] = node->fid[idx];
+                        flag[2] = node->lid[idx];
+                        flag[3] = node->gst[idx];
+                        memcpy(buf, flag, EXFLAG * sizeof(int));
+                        buf = buf + EXFLAG * sizeof(int);
+                        break;
+                }
+            }
+        }
+    }
+    return;
+}
+static void UnpackNodeData(const int type, const int tn, int box[restrict][LIMIT],
+        const Partition *const part, Node *const node, const unsigned char *buf)
+{
+    int idx = 0; /* linear array index math variable */
+    int flag[EXFLAG] = {0};
+    Real U[DIMU] = {0.0};
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                switch (type) {
+                    case EXFIELD:
+                        memcpy(U, buf, DIMU * sizeof(Real));
+                        StoreU(tn, idx, U, node);
+                        buf = buf + DIMU * sizeof(Real);
+                        break;
+                    default:
+                        memcpy(flag, buf, EXFLAG * sizeof(int));
+                        buf = buf + EXFLAG * sizeof(int);
+                        node->did[idx] = flag[0];
+                        node->fid[idx] = flag[1];
+                        node->lid[idx] = flag[2];
+                        node->gst[idx] = flag[3];
+                        break;
+                }
+            }
+        }
+    }
+    return;
+}
+static MPI_Datatype RealType(void)
+{
+    if (sizeof(Real) == sizeof(double)) {
+        return MPI_DOUBLE;
+    }
+    return MPI_FLOAT;
+}
+/*
+ * Lexicographic comparison of node keys in k, j, i order, which is the
+ * order of a nested node scanning loop.
+ */
+static int CompareKey(const int a[restrict], const int b[restrict])
+{
+    for (int s = Z; s >= X; --s) {
+        if (a[s] != b[s]) {
+            return (a[s] < b[s]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+#endif
+/* a good practice: end file with a newline */
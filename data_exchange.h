@@ -0,0 +1,69 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_DATA_EXCHANGE_H_ /* if undefined */
+#define ARTRACFD_DATA_EXCHANGE_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    FCN = 5, /* surface force statistics: lidN, gstN, offset, mean, variance */
+} ExConst;
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Distributed memory environment
+ *
+ * Function
+ *      Initialize and finalize the message passing environment. Without
+ *      the ARTRACFD_MPI build flag, there is only one processor and all
+ *      the data exchange functions do nothing.
+ */
+extern void InitializeDataExchange(Partition *);
+extern void FinalizeDataExchange(void);
+/*
+ * Processor topology
+ *
+ * Function
+ *      Arrange processors into a Cartesian block grid and record the block
+ *      coordinates and the neighbouring processor of each boundary.
+ */
+extern void CreateExchangeTopology(Partition *);
+/*
+ * Halo exchange
+ *
+ * Function
+ *      Fill the ghost layers shared with neighbouring blocks by the
+ *      field data at time level tn or by the geometric field data.
+ */
+extern void ExchangeFieldData(const int tn, Space *);
+extern void ExchangeDomainField(Space *);
+/*
+ * Global reductions
+ *
+ * Function
+ *      Reduce the maximum of a real array over all processors.
+ *      Reduce the surface force sums and statistics of each polyhedron.
+ *      Merge the colliding lists of a polyhedron detected by each processor
+ *      into the global node scanning order.
+ */
+extern void ReduceMaxReal(const int n, Real v[]);
+extern void ReduceSurfaceForce(Real (*stat)[FCN], Geometry *const);
+extern void ReduceCollision(Geometry *const);
+#endif
+/* a good practice: end file with a newline */
@@ -14,9 +14,38 @@
 #include "data_probe.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* support for abs operation */
+#include <string.h> /* manipulating strings */
 #include "computational_geometry.h"
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void InitializePointSeries(const Time *, const Space *);
+static void InitializeForceSeries(const Time *, const Space *, const Model *);
+static void InitializeSeries(const Time *, const Partition *const, DpSeries *);
+static void RecordSample(DpSeries *);
+static void FlushSeries(DpSeries *);
+static void WriteSeriesHeader(FILE *, const DpSeries *);
+static void NameSeriesFile(const DpSeries *, const char *, char *);
+static void RetrieveSeries(DpSeries *);
+static int InBlock(const int [restrict], const int [restrict], const int [restrict],
+        const Partition *const);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static DpSeries pointSeries = {
+    .name = "point_probe",
+    .tag = "probe",
+    .var = "rho, u, v, w, p, T",
+    .varN = 6,
+};
+static DpSeries forceSeries = {
+    .name = "surface_force",
+    .tag = "body",
+    .var = "Fpx, Fpy, Fpz, Fvx, Fvy, Fvz, Ttx, Tty, Ttz",
+    .varN = 9,
+};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -25,37 +54,62 @@ void WritePointProbeData(const Time *time, const Space *space, const Model *mode
     if (0 == time->dataN[PROPT]) {
         return;
     }
-    FILE *fp = NULL;
-    String fname = {'\0'};
-    const Partition *const part = &(space->part);
+    DpSeries *const series = &pointSeries;
+    if (0 == series->state) {
+        InitializePointSeries(time, space);
+    }
     const Node *const node = space->node;
-    int idx = 0; /* linear array index math variable */
+    Real U[DIMU] = {0.0};
     Real Uo[DIMUo] = {0.0};
+    Real *sample = series->ring + series->sampleN * (1 + series->entN * series->varN);
+    *sample = time->now;
+    ++sample;
+    for (int n = 0; n < series->entN; ++n) {
+        LoadU(TO, series->idx[n], node, U);
+        MapPrimitive(model->gamma, model->gasR, U, Uo);
+        for (int m = 0; m < series->varN; ++m, ++sample) {
+            *sample = Uo[m];
+        }
+    }
+    RecordSample(series);
+    return;
+}
+/*
+ * The probed nodes are fixed during a run, hence they are located once.
+ */
+static void InitializePointSeries(const Time *time, const Space *space)
+{
+    DpSeries *const series = &pointSeries;
+    const Partition *const part = &(space->part);
     const IntVec nMin = {part->ns[PHY][X][MIN], part->ns[PHY][Y][MIN], part->ns[PHY][Z][MIN]};
     const IntVec nMax = {part->ns[PHY][X][MAX], part->ns[PHY][Y][MAX], part->ns[PHY][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
     RealVec p1 = {0.0};
+    IntVec u = {0}; /* unconfined node */
     int i = 0, j = 0, k = 0;
+    series->id = AssignStorage(time->dataN[PROPT] * sizeof(*series->id));
+    series->idx = AssignStorage(time->dataN[PROPT] * sizeof(*series->idx));
+    series->entN = 0;
     for (int n = 0; n < time->dataN[PROPT]; ++n) {
-        snprintf(fname, sizeof(fname), "%s%03d.csv", "point_probe_", n + 1);
-        fp = Fopen(fname, "a");
-        if (0 == time->stepC) { /* initialization step */
-            fprintf(fp, "# time, rho, u, v, w, p, T\n");
-        }
         p1[X] = time->pp[n][0];
         p1[Y] = time->pp[n][1];
         p1[Z] = time->pp[n][2];
-        i = ConfineSpace(MapNode(p1[X], sMin[X], dd[X], ng[X]), nMin[X], nMax[X]);
-        j = ConfineSpace(MapNode(p1[Y], sMin[Y], dd[Y], ng[Y]), nMin[Y], nMax[Y]);
-        k = ConfineSpace(MapNode(p1[Z], sMin[Z], dd[Z], ng[Z]), nMin[Z], nMax[Z]);
-        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-        MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
-        fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
-                time->now, Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
-        fclose(fp);
+        for (int s = 0; s < DIMS; ++s) {
+            u[s] = MapNode(p1[s], sMin[s], dd[s], no[s]);
+        }
+        if (!InBlock(u, nMin, nMax, part)) { /* probed by another processor */
+            continue;
+        }
+        i = ConfineSpace(u[X], nMin[X], nMax[X]);
+        j = ConfineSpace(u[Y], nMin[Y], nMax[Y]);
+        k = ConfineSpace(u[Z], nMin[Z], nMax[Z]);
+        series->id[series->entN] = n + 1;
+        series->idx[series->entN] = IndexNode(k, j, i, part->n[Y], part->n[X]);
+        ++(series->entN);
     }
+    InitializeSeries(time, part, series);
     return;
 }
 void WriteLineProbeData(const Time *time, const Space *space, const Model *model)
@@ -69,20 +123,26 @@ void WriteLineProbeData(const Time *time, const Space *space, const Model *model
     const Node *const node = space->node;
     int idx = 0; /* linear array index math variable */
     int idxOld = 0; /* linear array index math variable */
+    Real U[DIMU] = {0.0};
     Real Uo[DIMUo] = {0.0};
     const IntVec nMin = {part->ns[PHY][X][MIN], part->ns[PHY][Y][MIN], part->ns[PHY][Z][MIN]};
     const IntVec nMax = {part->ns[PHY][X][MAX], part->ns[PHY][Y][MAX], part->ns[PHY][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
     RealVec p1 = {0.0};
     RealVec p2 = {0.0};
     RealVec dl = {0.0};
+    IntVec u = {0}; /* unconfined node */
     int stepN = 0;
     int i = 0, j = 0, k = 0;
     for (int n = 0; n < time->dataN[PROLN]; ++n) {
-        snprintf(fname, sizeof(fname), "%s%03d_%05d.csv", "line_probe_", n + 1, time->stepC);
+        if (1 < part->rankN) { /* each processor writes its own segment */
+            snprintf(fname, sizeof(fname), "%s%03d_%05d_%04d.csv", "line_probe_", n + 1, time->stepC, part->rank);
+        } else {
+            snprintf(fname, sizeof(fname), "%s%03d_%05d.csv", "line_probe_", n + 1, time->stepC);
+        }
         fp = Fopen(fname, "w");
         fprintf(fp, "# x, y, z, rho, u, v, w, p, T <time=%.6g>\n", time->now);
         p1[X] = time->lp[n][0];
@@ -97,18 +157,25 @@ void WriteLineProbeData(const Time *time, const Space *space, const Model *model
         dl[Z] = (p2[Z] - p1[Z]) / (Real)(stepN);
         idxOld = -1; /* used to avoid repeating node for tiny step sizes */
         for (int m = 0; m <= stepN; ++m) {
-            i = ConfineSpace(MapNode(p1[X] + m * dl[X], sMin[X], dd[X], ng[X]), nMin[X], nMax[X]);
-            j = ConfineSpace(MapNode(p1[Y] + m * dl[Y], sMin[Y], dd[Y], ng[Y]), nMin[Y], nMax[Y]);
-            k = ConfineSpace(MapNode(p1[Z] + m * dl[Z], sMin[Z], dd[Z], ng[Z]), nMin[Z], nMax[Z]);
+            for (int s = 0; s < DIMS; ++s) {
+                u[s] = MapNode(p1[s] + m * dl[s], sMin[s], dd[s], no[s]);
+            }
+            if (!InBlock(u, nMin, nMax, part)) {
+                continue;
+            }
+            i = ConfineSpace(u[X], nMin[X], nMax[X]);
+            j = ConfineSpace(u[Y], nMin[Y], nMax[Y]);
+            k = ConfineSpace(u[Z], nMin[Z], nMax[Z]);
             idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
             if (idxOld == idx) {
                 continue;
             }
             idxOld = idx; /* record */
-            p2[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-            p2[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-            p2[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-            MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+            p2[X] = MapPoint(i, sMin[X], d[X], no[X]);
+            p2[Y] = MapPoint(j, sMin[Y], d[Y], no[Y]);
+            p2[Z] = MapPoint(k, sMin[Z], d[Z], no[Z]);
+            LoadU(TO, idx, node, U);
+            MapPrimitive(model->gamma, model->gasR, U, Uo);
             fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
                     p2[X], p2[Y], p2[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
         }
@@ -128,13 +195,14 @@ void WriteCurveProbeData(const Time *time, const Space *space, const Model *mode
     const Geometry *const geo = &(space->geo);
     const Polyhedron *poly = NULL;
     int idx = 0; /* linear array index math variable */
+    Real U[DIMU] = {0.0};
     Real Uo[DIMUo] = {0.0};
     const IntVec nMin = {part->ns[PHY][X][MIN], part->ns[PHY][Y][MIN], part->ns[PHY][Z][MIN]};
     const IntVec nMax = {part->ns[PHY][X][MAX], part->ns[PHY][Y][MAX], part->ns[PHY][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
     RealVec pG = {0.0}; /* ghost point */
     RealVec pO = {0.0}; /* boundary point */
     RealVec pI = {0.0}; /* image point */
@@ -142,26 +210,31 @@ void WriteCurveProbeData(const Time *time, const Space *space, const Model *mode
     int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
-        snprintf(fname, sizeof(fname), "%s%03d_%05d.csv", "curve_probe_", n + 1, time->stepC);
+        if (1 < part->rankN) { /* each processor writes its own segment */
+            snprintf(fname, sizeof(fname), "%s%03d_%05d_%04d.csv", "curve_probe_", n + 1, time->stepC, part->rank);
+        } else {
+            snprintf(fname, sizeof(fname), "%s%03d_%05d.csv", "curve_probe_", n + 1, time->stepC);
+        }
         fp = Fopen(fname, "w");
         fprintf(fp, "# x, y, z, Nx, Ny, Nz, rho, u, v, w, p, T <time=%.6g>\n", time->now);
         /* determine search range according to bounding box of polyhedron and valid node space */
         for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], no[s]), nMin[s], nMax[s]);
+            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], no[s]), nMin[s], nMax[s]) + 1;
         }
         for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
             for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
                 for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].gst) || (n + 1 != node[idx].did)) {
+                    if ((1 != node->gst[idx]) || (n + 1 != node->did[idx])) {
                         continue;
                     }
-                    pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                    ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+                    pG[X] = MapPoint(i, sMin[X], d[X], no[X]);
+                    pG[Y] = MapPoint(j, sMin[Y], d[Y], no[Y]);
+                    pG[Z] = MapPoint(k, sMin[Z], d[Z], no[Z]);
+                    ComputeGeometricData(pG, node->fid[idx], poly, pO, pI, N);
+                    LoadU(TO, idx, node, U);
+                    MapPrimitive(model->gamma, model->gasR, U, Uo);
                     fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
                             pO[X], pO[Y], pO[Z], N[X], N[Y], N[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
                 }
@@ -173,27 +246,293 @@ void WriteCurveProbeData(const Time *time, const Space *space, const Model *mode
 }
 void WriteSurfaceForceData(const Time *time, const Space *space, const Model *model)
 {
-    if (0 == time->dataN[PROFC]) {
+    if ((0 == time->dataN[PROFC]) || (0 != space->part.rank)) {
         return;
     }
-    FILE *fp = NULL;
-    String fname = {'\0'};
+    DpSeries *const series = &forceSeries;
+    if (0 == series->state) {
+        InitializeForceSeries(time, space, model);
+    }
     const Geometry *const geo = &(space->geo);
     const Polyhedron *poly = NULL;
-    for (int n = 0; n < geo->totN; ++n) {
+    Real *sample = series->ring + series->sampleN * (1 + series->entN * series->varN);
+    *sample = time->now;
+    ++sample;
+    for (int n = 0; n < series->entN; ++n, sample += series->varN) {
         poly = geo->poly + n;
-        snprintf(fname, sizeof(fname), "%s%03d.csv", "surface_force_", n + 1);
-        fp = Fopen(fname, "a");
-        if (0 == time->stepC) { /* initialization step */
-            fprintf(fp, "# time, Fpx, Fpy, Fpz, Fvx, Fvy, Fvz, Ttx, Tty, Ttz <model.mid=%d>\n", model->mid);
-        }
-        fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
-                time->now, poly->Fp[X], poly->Fp[Y], poly->Fp[Z],
-                poly->Fv[X], poly->Fv[Y], poly->Fv[Z],
-                poly->Tt[X], poly->Tt[Y], poly->Tt[Z]);
+        for (int s = 0; s < DIMS; ++s) {
+            sample[s] = poly->Fp[s];
+            sample[DIMS + s] = poly->Fv[s];
+            sample[2 * DIMS + s] = poly->Tt[s];
+        }
+    }
+    RecordSample(series);
+    return;
+}
+static void InitializeForceSeries(const Time *time, const Space *space, const Model *model)
+{
+    DpSeries *const series = &forceSeries;
+    const Geometry *const geo = &(space->geo);
+    series->id = AssignStorage((geo->totN + 1) * sizeof(*series->id));
+    series->entN = geo->totN;
+    for (int n = 0; n < series->entN; ++n) {
+        series->id[n] = n + 1;
+    }
+    series->mid = model->mid;
+    InitializeSeries(time, &(space->part), series);
+    series->rank = -1; /* only the root processor writes surface forces */
+    return;
+}
+/*
+ * A slice probe is the node plane nearest to the given coordinate. It is
+ * written as image data, which is described by its origin and spacing
+ * instead of point coordinates, with the variables appended in raw binary.
+ * Extents are global node indices, so the pieces of processors sharing the
+ * plane fit together, and the time is stored as field data.
+ */
+void WriteSliceProbeData(const Time *time, const Space *space, const Model *model)
+{
+    if (0 == time->dataN[PROSL]) {
+        return;
+    }
+    FILE *fp = NULL;
+    String fname = {'\0'};
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    int idx = 0; /* linear array index math variable */
+    Real U[DIMU] = {0.0};
+    Real Uo[DIMUo] = {0.0};
+    const char *var[] = {"rho", "u", "v", "w", "p", "T", "did"};
+    const int varN = sizeof(var) / sizeof(*var);
+    const int one = 1;
+    const char *byteOrder = (1 == *(const unsigned char *)&one) ? "LittleEndian" : "BigEndian";
+    const IntVec nMin = {part->ns[PHY][X][MIN], part->ns[PHY][Y][MIN], part->ns[PHY][Z][MIN]};
+    const IntVec nMax = {part->ns[PHY][X][MAX], part->ns[PHY][Y][MAX], part->ns[PHY][Z][MAX]};
+    IntVec u = {0}; /* unconfined node */
+    int ns[DIMS][LIMIT] = {{0}}; /* node range of the plane */
+    float *data = NULL; /* values of each variable on the plane */
+    unsigned long long byteN = 0; /* byte size of binary data array */
+    size_t nodeN = 0;
+    size_t m = 0;
+    int s = 0; /* normal axis */
+    for (int n = 0; n < time->dataN[PROSL]; ++n) {
+        s = (int)time->sp[n][0];
+        memcpy(u, nMin, sizeof(u));
+        u[s] = MapNode(time->sp[n][1], part->domain[s][MIN], part->dd[s], part->no[s]);
+        if (!InBlock(u, nMin, nMax, part)) {
+            continue;
+        }
+        memcpy(ns, part->ns[PIO], sizeof(ns));
+        ns[s][MIN] = ConfineSpace(u[s], nMin[s], nMax[s]);
+        ns[s][MAX] = ns[s][MIN] + 1;
+        nodeN = (size_t)(ns[X][MAX] - ns[X][MIN]) * (ns[Y][MAX] - ns[Y][MIN]) * (ns[Z][MAX] - ns[Z][MIN]);
+        data = AssignStorage(varN * nodeN * sizeof(*data));
+        m = 0;
+        for (int k = ns[Z][MIN]; k < ns[Z][MAX]; ++k) {
+            for (int j = ns[Y][MIN]; j < ns[Y][MAX]; ++j) {
+                for (int i = ns[X][MIN]; i < ns[X][MAX]; ++i, ++m) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    LoadU(TO, idx, node, U);
+                    MapPrimitive(model->gamma, model->gasR, U, Uo);
+                    for (int v = 0; v < varN - 1; ++v) {
+                        data[v * nodeN + m] = Uo[v];
+                    }
+                    data[(varN - 1) * nodeN + m] = node->did[idx];
+                }
+            }
+        }
+        if (1 < part->rankN) { /* each processor writes its own piece */
+            snprintf(fname, sizeof(fname), "%s%03d_%05d_%04d.vti", "slice_probe_", n + 1, time->stepC, part->rank);
+        } else {
+            snprintf(fname, sizeof(fname), "%s%03d_%05d.vti", "slice_probe_", n + 1, time->stepC);
+        }
+        fp = Fopen(fname, "wb");
+        fprintf(fp, "<?xml version=\"1.0\"?>\n");
+        fprintf(fp, "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\">\n",
+                byteOrder);
+        fprintf(fp, "  <ImageData WholeExtent=\"%d %d %d %d %d %d\" Origin=\"%.12g %.12g %.12g\" Spacing=\"%.12g %.12g %.12g\">\n",
+                ns[X][MIN] - part->no[X], ns[X][MAX] - 1 - part->no[X],
+                ns[Y][MIN] - part->no[Y], ns[Y][MAX] - 1 - part->no[Y],
+                ns[Z][MIN] - part->no[Z], ns[Z][MAX] - 1 - part->no[Z],
+                part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN],
+                part->d[X], part->d[Y], part->d[Z]);
+        fprintf(fp, "    <FieldData>\n");
+        fprintf(fp, "      <DataArray type=\"Float64\" Name=\"TimeValue\" NumberOfTuples=\"1\" format=\"ascii\">\n");
+        fprintf(fp, "        %.12g\n", time->now);
+        fprintf(fp, "      </DataArray>\n");
+        fprintf(fp, "    </FieldData>\n");
+        fprintf(fp, "    <Piece Extent=\"%d %d %d %d %d %d\">\n",
+                ns[X][MIN] - part->no[X], ns[X][MAX] - 1 - part->no[X],
+                ns[Y][MIN] - part->no[Y], ns[Y][MAX] - 1 - part->no[Y],
+                ns[Z][MIN] - part->no[Z], ns[Z][MAX] - 1 - part->no[Z]);
+        fprintf(fp, "      <PointData>\n");
+        byteN = nodeN * sizeof(*data);
+        for (int v = 0; v < varN; ++v) {
+            fprintf(fp, "        <DataArray type=\"Float32\" Name=\"%s\" format=\"appended\" offset=\"%llu\"/>\n",
+                    var[v], v * (sizeof(byteN) + byteN));
+        }
+        fprintf(fp, "      </PointData>\n");
+        fprintf(fp, "      <CellData>\n");
+        fprintf(fp, "      </CellData>\n");
+        fprintf(fp, "    </Piece>\n");
+        fprintf(fp, "  </ImageData>\n");
+        fprintf(fp, "  <AppendedData encoding=\"raw\">\n");
+        fprintf(fp, "   _");
+        for (int v = 0; v < varN; ++v) {
+            fwrite(&byteN, sizeof(byteN), 1, fp);
+            fwrite(data + v * nodeN, sizeof(*data), nodeN, fp);
+        }
+        fprintf(fp, "\n  </AppendedData>\n");
+        fprintf(fp, "</VTKFile>\n");
         fclose(fp);
+        RetrieveStorage(data);
+    }
+    return;
+}
+/*
+ * A series started by the initialization step creates its files, while a
+ * restarted one appends to them. The buffer holds DPRINGN samples.
+ */
+static void InitializeSeries(const Time *time, const Partition *const part, DpSeries *series)
+{
+    series->rank = (1 < part->rankN) ? part->rank : -1; /* a file for each processor */
+    series->state = (0 == time->stepC) ? DPCREATE : DPAPPEND;
+    series->sampleN = 0;
+    series->ring = AssignStorage(DPRINGN * (1 + series->entN * series->varN) * sizeof(*series->ring));
+    TickTime(&(series->tm));
+    return;
+}
+static void RecordSample(DpSeries *series)
+{
+    ++(series->sampleN);
+    if ((DPRINGN == series->sampleN) || (DPFLUSHT <= TockTime(&(series->tm)))) {
+        FlushSeries(series);
     }
     return;
 }
+/*
+ * Each flush opens the binary file and its csv export once, whatever the
+ * number of entries and buffered samples.
+ */
+static void FlushSeries(DpSeries *series)
+{
+    if ((0 == series->sampleN) || (0 == series->entN)) {
+        series->sampleN = 0;
+        return;
+    }
+    String fname = {'\0'};
+    const char *mode = (DPCREATE == series->state) ? "w" : "a";
+    const int sizeS = 1 + series->entN * series->varN; /* values of a sample */
+    const Real *sample = series->ring;
+    NameSeriesFile(series, ".dat", fname);
+    FILE *fp = Fopen(fname, (DPCREATE == series->state) ? "wb" : "ab");
+    fseek(fp, 0, SEEK_END);
+    if (0 == ftell(fp)) {
+        WriteSeriesHeader(fp, series);
+    }
+    fwrite(series->ring, sizeof(*series->ring), series->sampleN * sizeS, fp);
+    fclose(fp);
+    NameSeriesFile(series, ".csv", fname);
+    fp = Fopen(fname, mode);
+    fseek(fp, 0, SEEK_END);
+    if (0 == ftell(fp)) {
+        fprintf(fp, "# time, %s, %s", series->tag, series->var);
+        if (&forceSeries == series) {
+            fprintf(fp, " <model.mid=%d>", series->mid);
+        }
+        fprintf(fp, "\n");
+    }
+    for (int m = 0; m < series->sampleN; ++m, sample += sizeS) {
+        for (int n = 0; n < series->entN; ++n) {
+            fprintf(fp, "%.6g, %d", sample[0], series->id[n]);
+            for (int v = 1 + n * series->varN; v <= (n + 1) * series->varN; ++v) {
+                fprintf(fp, ", %.6g", sample[v]);
+            }
+            fprintf(fp, "\n");
+        }
+    }
+    fclose(fp);
+    series->state = DPAPPEND;
+    series->sampleN = 0;
+    TickTime(&(series->tm));
+    return;
+}
+/*
+ * The text header ends with a marker line, after which each record is a
+ * sample of native reals: the time and then the values of each entry.
+ */
+static void WriteSeriesHeader(FILE *fp, const DpSeries *series)
+{
+    const int one = 1;
+    fprintf(fp, "# ArtraCFD probe series: %s\n", series->name);
+    if (0 <= series->rank) {
+        fprintf(fp, "# rank: %d\n", series->rank);
+    }
+    fprintf(fp, "# record: time, then %s of each entry\n", series->var);
+    fprintf(fp, "# real: %d bytes, %s\n", (int)sizeof(*series->ring),
+            (1 == *(const char *)&one) ? "LittleEndian" : "BigEndian");
+    fprintf(fp, "# entries: %d\n", series->entN);
+    fprintf(fp, "# %s:", series->tag);
+    for (int n = 0; n < series->entN; ++n) {
+        fprintf(fp, " %d", series->id[n]);
+    }
+    fprintf(fp, "\n");
+    if (&forceSeries == series) {
+        fprintf(fp, "# model.mid: %d\n", series->mid);
+    }
+    fprintf(fp, "# end of header\n");
+    return;
+}
+static void NameSeriesFile(const DpSeries *series, const char *ext, char *fname)
+{
+    if (0 > series->rank) {
+        snprintf(fname, sizeof(String), "%s%s", series->name, ext);
+    } else {
+        snprintf(fname, sizeof(String), "%s_%04d%s", series->name, series->rank, ext);
+    }
+    return;
+}
+void FlushProbeData(void)
+{
+    FlushSeries(&pointSeries);
+    FlushSeries(&forceSeries);
+    return;
+}
+void FinalizeProbeData(void)
+{
+    FlushProbeData();
+    RetrieveSeries(&pointSeries);
+    RetrieveSeries(&forceSeries);
+    return;
+}
+static void RetrieveSeries(DpSeries *series)
+{
+    RetrieveStorage(series->id);
+    RetrieveStorage(series->idx);
+    RetrieveStorage(series->ring);
+    series->id = NULL;
+    series->idx = NULL;
+    series->ring = NULL;
+    series->state = 0;
+    return;
+}
+/*
+ * A probed node belongs to the processor whose physical node range covers
+ * it, while nodes outside the global domain are confined to the processors
+ * at the global boundaries, as a single block does.
+ */
+static int InBlock(const int u[restrict], const int nMin[restrict], const int nMax[restrict],
+        const Partition *const part)
+{
+    for (int s = 0; s < DIMS; ++s) {
+        if ((nMin[s] > u[s]) && (0 != part->coord[s])) {
+            return 0;
+        }
+        if ((nMax[s] <= u[s]) && (part->proc[s] - 1 != part->coord[s])) {
+            return 0;
+        }
+    }
+    return 1;
+}
 /* a good practice: end file with a newline */
 
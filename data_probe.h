@@ -17,16 +17,59 @@
  * Required Header Files
  ****************************************************************************/
 #include "commons.h"
+#include "timer.h"
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
+typedef enum {
+    DPRINGN = 64, /* samples buffered before a series is flushed */
+    DPFLUSHT = 60, /* seconds a buffered sample waits at most */
+    DPCREATE = 1, /* series file to be created */
+    DPAPPEND = 2, /* series file to be appended */
+} DpConst;
+typedef struct {
+    const char *name; /* file root name */
+    int rank; /* processor rank in file names, negative if not required */
+    const char *tag; /* column name of the entry identifier */
+    const char *var; /* column names of the values of an entry */
+    int varN; /* number of values of an entry */
+    int entN; /* number of entries sampled by this processor */
+    int mid; /* material identifier */
+    int state; /* file state, zero if not yet set up */
+    int sampleN; /* number of buffered samples */
+    int *id; /* identifier of each entry */
+    int *idx; /* node index of each entry */
+    Real *ring; /* buffered samples, the time and then the values of each entry */
+    Timer tm; /* timer since the last flush */
+} DpSeries; /* time series of a probe family */
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
+/*
+ * Data probe writers
+ *
+ * Function
+ *      Write the probed data. Point probes and surface forces are time
+ *      series, which are buffered in memory and flushed every DPRINGN
+ *      samples or DPFLUSHT seconds to a single binary file per probe
+ *      family with a text header, and to a csv export of it. Slice
+ *      probes are axis-aligned node planes written as two-dimensional
+ *      image data in binary, at their own writing frequency.
+ */
 extern void WritePointProbeData(const Time *, const Space *, const Model *);
 extern void WriteLineProbeData(const Time *, const Space *, const Model *);
 extern void WriteCurveProbeData(const Time *, const Space *, const Model *);
 extern void WriteSurfaceForceData(const Time *, const Space *, const Model *);
+extern void WriteSliceProbeData(const Time *, const Space *, const Model *);
+/*
+ * Flush the buffered time series, for instance to keep them consistent
+ * with a checkpoint.
+ */
+extern void FlushProbeData(void);
+/*
+ * Flush the buffered time series and release their storage.
+ */
+extern void FinalizeProbeData(void);
 #endif
 /* a good practice: end file with a newline */
 
@@ -15,9 +15,16 @@
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
 #include <float.h> /* size of floating point values */
+#ifndef ARTRACFD_SYNC_IO
+#include <pthread.h> /* POSIX threads */
+#endif
+#ifdef _OPENMP
+#include <omp.h> /* openmp runtime routines */
+#endif
 #include "paraview.h"
 #include "ensight.h"
 #include "data_probe.h"
+#include "checkpoint.h"
 #include "commons.h"
 /****************************************************************************
  * Function Pointers
@@ -32,30 +39,50 @@ typedef void (*PolyDataReader)(const Time *, Geometry *const);
  * Static Function Declarations
  ****************************************************************************/
 static void WriteSpaceData(const Time *, const Space *, const Model *);
+static void WriteSnapshot(const Time *, const Space *, const Model *);
 static void ReadSpaceData(Time *, Space *, const Model *);
 static void WriteFieldData(const Time *, const Space *, const Model *);
 static void ReadFieldData(Time *, Space *, const Model *);
 static void WriteGeometryData(const Time *, const Geometry *const);
 static void ReadGeometryData(const Time *, Geometry *const);
 static void WriteStateData(const Time *);
+#ifndef ARTRACFD_SYNC_IO
+static void StageSnapshot(const Time *, const Space *, const Model *, DsSlot *);
+static void *CopyStorage(void *, const void *, const size_t);
+static void *RunDataWriter(void *);
+#endif
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
+#ifndef ARTRACFD_SYNC_IO
+static DsSlot slot[DSSLOTN]; /* staging buffers, written in turn */
+static int next = 0; /* the staging buffer for the next snapshot */
+static int active = 0; /* whether the background writer is running */
+static int quit = 0; /* request the background writer to stop */
+static pthread_t writer; /* background writer */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER; /* guard of staging states */
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER; /* signal of staging state change */
+#endif
 static UnifiedDataWriter UnifiedWriteData[NPROBE] = {
     WritePointProbeData,
     WriteLineProbeData,
     WriteCurveProbeData,
     WriteSurfaceForceData,
+    WriteSliceProbeData,
     WriteSpaceData};
 static UnifiedDataReader UnifiedReadData[NPROBE] = {
     ReadSpaceData,
     ReadSpaceData,
     ReadSpaceData,
     ReadSpaceData,
+    ReadSpaceData,
     ReadSpaceData};
 static StructuredDataWriter WriteStructuredData[2] = {
     WriteStructuredDataParaview,
     WriteStructuredDataEnsight};
+static StructuredDataWriter WriteStatisticsData[2] = {
+    WriteStatisticsDataParaview,
+    WriteStatisticsDataEnsight};
 static StructuredDataReader ReadStructuredData[2] = {
     ReadStructuredDataParaview,
     ReadStructuredDataEnsight};
@@ -78,9 +105,90 @@ void ReadData(const int n, Time *time, Space *space, const Model *model)
     UnifiedReadData[n](time, space, model);
     return;
 }
+void InitializeDataStream(void)
+{
+#ifndef ARTRACFD_SYNC_IO
+    quit = 0;
+    next = 0;
+#ifdef _OPENMP
+    if (1 >= omp_get_num_procs()) { /* no spare processor to overlap with */
+        return;
+    }
+#endif
+    active = (0 == pthread_create(&writer, NULL, RunDataWriter, NULL));
+    if (!active) {
+        ShowWarning("background data writer not started, data are written in place\n");
+    }
+#endif
+    return;
+}
+void FinalizeDataStream(void)
+{
+#ifndef ARTRACFD_SYNC_IO
+    if (!active) {
+        return;
+    }
+    pthread_mutex_lock(&lock);
+    quit = 1;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+    pthread_join(writer, NULL);
+    active = 0;
+    for (int n = 0; n < DSSLOTN; ++n) {
+        Geometry *const geo = &(slot[n].space.geo);
+        RetrieveStorage(slot[n].node.pool);
+        RetrieveStorage(slot[n].node.stat);
+        RetrieveStorage(geo->poly);
+        RetrieveStorage(geo->pair);
+        RetrieveStorage(geo->drift);
+        RetrieveStorage(geo->ghost);
+        RetrieveStorage(geo->ghostO);
+        RetrieveStorage(geo->sten);
+        RetrieveStorage(geo->stenW);
+        memset(slot + n, 0, sizeof(*slot));
+    }
+#endif
+    return;
+}
+/*
+ * A snapshot is copied into a staging buffer and handed to the background
+ * writer, then the solver carries on while the files are being written.
+ * The solver waits only when all the staging buffers are still busy.
+ * Snapshots are written in turn, and the state log goes after the data it
+ * records, so the log never refers to a snapshot that is not on disk.
+ */
 static void WriteSpaceData(const Time *time, const Space *space, const Model *model)
+{
+    FlushProbeData(); /* keep the time series consistent with the checkpoint */
+#ifndef ARTRACFD_SYNC_IO
+    if (active) {
+        DsSlot *const s = slot + next;
+        pthread_mutex_lock(&lock);
+        while (DSFULL == s->state) {
+            pthread_cond_wait(&cond, &lock);
+        }
+        pthread_mutex_unlock(&lock);
+        StageSnapshot(time, space, model, s);
+        pthread_mutex_lock(&lock);
+        s->state = DSFULL;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&lock);
+        next = (next + 1) % DSSLOTN;
+        return;
+    }
+#endif
+    WriteSnapshot(time, space, model);
+    return;
+}
+static void WriteSnapshot(const Time *time, const Space *space, const Model *model)
 {
     WriteFieldData(time, space, model);
+    if ((0 != time->ckW) && (0 == time->dataC % time->ckW)) {
+        WriteCheckpoint(time, space); /* each processor dumps its exact state */
+    }
+    if (0 != space->part.rank) { /* shared data are written by the root processor */
+        return;
+    }
     WriteGeometryData(time, &(space->geo));
     WriteStateData(time);
     return;
@@ -94,6 +202,9 @@ static void ReadSpaceData(Time *time, Space *space, const Model *model)
 static void WriteFieldData(const Time *time, const Space *space, const Model *model)
 {
     WriteStructuredData[time->dataStreamer](time, space, model);
+    if (0 != time->statW) {
+        WriteStatisticsData[time->dataStreamer](time, space, model);
+    }
     return;
 }
 static void ReadFieldData(Time *time, Space *space, const Model *model)
@@ -128,6 +239,103 @@ static void WriteStateData(const Time *time)
     fclose(fp);
     return;
 }
+#ifndef ARTRACFD_SYNC_IO
+static void StageSnapshot(const Time *time, const Space *space, const Model *model, DsSlot *s)
+{
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    const Geometry *const geo = &(space->geo);
+    const int totN = part->n[X] * part->n[Y] * part->n[Z];
+    Node *const stage = &(s->node);
+    if (NULL == stage->pool) {
+        stage->pool = AssignStorage(4 * totN * sizeof(int) + DIMU * totN * sizeof(Real));
+        stage->U[TO][0] = stage->pool;
+        for (int n = 1; n < DIMU; ++n) {
+            stage->U[TO][n] = stage->U[TO][n-1] + totN;
+        }
+        stage->did = (int *)(stage->U[TO][DIMU-1] + totN);
+        stage->fid = stage->did + totN;
+        stage->lid = stage->fid + totN;
+        stage->gst = stage->lid + totN;
+        stage->levelN = 1;
+    }
+    memcpy(stage->did, node->did, totN * sizeof(*node->did));
+    memcpy(stage->fid, node->fid, totN * sizeof(*node->fid));
+    memcpy(stage->lid, node->lid, totN * sizeof(*node->lid));
+    memcpy(stage->gst, node->gst, totN * sizeof(*node->gst));
+    for (int n = 0; n < DIMU; ++n) {
+        memcpy(stage->U[TO][n], node->U[TO][n], totN * sizeof(*node->U[TO][n]));
+    }
+    if (NULL != node->stat) {
+        if (NULL == stage->stat) {
+            stage->stat = AssignStorage((size_t)totN * DIMSTAT * sizeof(*stage->stat));
+        }
+        memcpy(stage->stat, node->stat, (size_t)totN * DIMSTAT * sizeof(*node->stat));
+    }
+    s->time = *time;
+    s->model = model;
+    s->space.node = stage;
+    s->space.part = *part;
+    /* polyhedron meshes are never altered, they are shared by reference */
+    Geometry *const sgeo = &(s->space.geo);
+    Geometry keep = *sgeo; /* storage of the staging buffer */
+    *sgeo = *geo;
+    sgeo->col = NULL;
+    memset(&(sgeo->bin), 0, sizeof(sgeo->bin));
+    sgeo->poly = CopyStorage(keep.poly, geo->poly, geo->totN * sizeof(*geo->poly));
+    if ((0 == time->ckW) || (0 != time->dataC % time->ckW)) { /* states only dumped by a checkpoint */
+        sgeo->pair = keep.pair;
+        sgeo->drift = keep.drift;
+        sgeo->ghost = keep.ghost;
+        sgeo->ghostO = keep.ghostO;
+        sgeo->sten = keep.sten;
+        sgeo->stenW = keep.stenW;
+        return;
+    }
+    sgeo->pair = CopyStorage(keep.pair, geo->pair, (geo->pairN + 1) * sizeof(*geo->pair));
+    sgeo->drift = CopyStorage(keep.drift, geo->drift, geo->totN * sizeof(*geo->drift));
+    const int ghostN = geo->ghostN[part->gl];
+    const int stenN = geo->ghost[ghostN][3];
+    sgeo->ghost = CopyStorage(keep.ghost, geo->ghost, (ghostN + 1) * sizeof(*geo->ghost));
+    sgeo->ghostO = CopyStorage(keep.ghostO, geo->ghostO, (ghostN + 1) * sizeof(*geo->ghostO));
+    sgeo->sten = CopyStorage(keep.sten, geo->sten, (stenN + 1) * sizeof(*geo->sten));
+    sgeo->stenW = CopyStorage(keep.stenW, geo->stenW, (stenN + 1) * sizeof(*geo->stenW));
+    return;
+}
+static void *CopyStorage(void *old, const void *data, const size_t size)
+{
+    RetrieveStorage(old);
+    if ((NULL == data) || (0 == size)) {
+        return NULL;
+    }
+    void *pointer = AssignStorage(size);
+    memcpy(pointer, data, size);
+    return pointer;
+}
+static void *RunDataWriter(void *arg)
+{
+    (void)arg;
+    int n = 0; /* the staging buffer to write */
+    while (1) {
+        pthread_mutex_lock(&lock);
+        while ((DSFULL != slot[n].state) && (0 == quit)) {
+            pthread_cond_wait(&cond, &lock);
+        }
+        if (DSFULL != slot[n].state) { /* stop after all snapshots are written */
+            pthread_mutex_unlock(&lock);
+            break;
+        }
+        pthread_mutex_unlock(&lock);
+        WriteSnapshot(&(slot[n].time), &(slot[n].space), slot[n].model);
+        pthread_mutex_lock(&lock);
+        slot[n].state = DSFREE;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&lock);
+        n = (n + 1) % DSSLOTN;
+    }
+    return NULL;
+}
+#endif
 void WritePolyStateData(const int pm, const int pn, FILE *fp, const Geometry *const geo)
 {
     const char *fmtI = "  %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %d\n";
@@ -20,9 +20,32 @@
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
+typedef enum {
+    DSSLOTN = 2, /* number of staging buffers of the background writer */
+    DSFREE = 0, /* staging buffer is free */
+    DSFULL = 1, /* staging buffer holds a snapshot to write */
+} DsConst;
+typedef struct {
+    int state; /* staging state */
+    Time time; /* time counters of the snapshot */
+    Space space; /* space data of the snapshot */
+    Node node; /* field data of the snapshot, only the current time level */
+    const Model *model; /* model of the snapshot */
+} DsSlot; /* staging buffer of a space data snapshot */
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
+/*
+ * Background data writer
+ *
+ * Function
+ *      Start and stop the thread that writes space data snapshots staged
+ *      by the solver. Stopping waits until all staged snapshots are on
+ *      disk. With the ARTRACFD_SYNC_IO build flag, or on a single
+ *      processor, snapshots are written by the solver directly.
+ */
+extern void InitializeDataStream(void);
+extern void FinalizeDataStream(void);
 extern void WriteData(const int n, const Time *, const Space *, const Model *);
 extern void ReadData(const int n, Time *, Space *, const Model *);
 extern void WritePolyStateData(const int pm, const int pn, FILE *fp, const Geometry *const);
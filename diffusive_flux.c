@@ -18,21 +18,17 @@
 /****************************************************************************
  * Function Pointers
  ****************************************************************************/
-typedef void (*FvhatReconstructor)(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
-        const Model *, Real [restrict]);
+typedef void (*FvhatReconstructor)(const int, const int, const int [restrict],
+        const Real [restrict], const Node *const, const Model *, Real [restrict]);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static void ComputeFvhatX(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
-        const Model *, Real [restrict]);
-static void ComputeFvhatY(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
-        const Model *, Real [restrict]);
-static void ComputeFvhatZ(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
-        const Model *, Real [restrict]);
+static void ComputeFvhatX(const int, const int, const int [restrict],
+        const Real [restrict], const Node *const, const Model *, Real [restrict]);
+static void ComputeFvhatY(const int, const int, const int [restrict],
+        const Real [restrict], const Node *const, const Model *, Real [restrict]);
+static void ComputeFvhatZ(const int, const int, const int [restrict],
+        const Real [restrict], const Node *const, const Model *, Real [restrict]);
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
@@ -43,8 +39,8 @@ static FvhatReconstructor ReconstructFvhat[DIMS] = {
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-void ComputeFvhat(const int tn, const int s, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+void ComputeFvhat(const int tn, const int s, const int idx, const int stride[restrict],
+        const Real dd[restrict], const Node *const node,
         const Model *model, Real Fvhat[restrict])
 {
     const Real zero = 0.0;
@@ -52,66 +48,66 @@ void ComputeFvhat(const int tn, const int s, const int k, const int j, const int
         memset(Fvhat, 0, DIMU * sizeof(*Fvhat));
         return;
     }
-    ReconstructFvhat[s](tn, k, j, i, partn, dd, node, model, Fvhat);
+    ReconstructFvhat[s](tn, idx, stride, dd, node, model, Fvhat);
     return;
 }
-static void ComputeFvhatX(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+static void ComputeFvhatX(const int tn, const int idx, const int stride[restrict],
+        const Real dd[restrict], const Node *const node,
         const Model *model, Real Fvhat[restrict])
 {
-    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxS = IndexNode(k, j - 1, i, partn[Y], partn[X]);
-    const int idxN = IndexNode(k, j + 1, i, partn[Y], partn[X]);
-    const int idxF = IndexNode(k - 1, j, i, partn[Y], partn[X]);
-    const int idxB = IndexNode(k + 1, j, i, partn[Y], partn[X]);
-
-    const int idxE = IndexNode(k, j, i + 1, partn[Y], partn[X]);
-    const int idxSE = IndexNode(k, j - 1, i + 1, partn[Y], partn[X]);
-    const int idxNE = IndexNode(k, j + 1, i + 1, partn[Y], partn[X]);
-    const int idxFE = IndexNode(k - 1, j, i + 1, partn[Y], partn[X]);
-    const int idxBE = IndexNode(k + 1, j, i + 1, partn[Y], partn[X]);
-
-    const Real *restrict U = node[idx].U[tn];
+    const int idxS = idx - stride[Y];
+    const int idxN = idx + stride[Y];
+    const int idxF = idx - stride[Z];
+    const int idxB = idx + stride[Z];
+
+    const int idxE = idx + stride[X];
+    const int idxSE = idx + stride[X] - stride[Y];
+    const int idxNE = idx + stride[X] + stride[Y];
+    const int idxFE = idx + stride[X] - stride[Z];
+    const int idxBE = idx + stride[X] + stride[Z];
+
+    Real U[DIMU];
+    LoadU(tn, idx, node, U);
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
     const Real T = ComputeTemperature(model->cv, U);
 
-    U = node[idxS].U[tn];
+    LoadU(tn, idxS, node, U);
     const Real uS = U[1] / U[0];
     const Real vS = U[2] / U[0];
 
-    U = node[idxN].U[tn];
+    LoadU(tn, idxN, node, U);
     const Real uN = U[1] / U[0];
     const Real vN = U[2] / U[0];
 
-    U = node[idxF].U[tn];
+    LoadU(tn, idxF, node, U);
     const Real uF = U[1] / U[0];
     const Real wF = U[3] / U[0];
 
-    U = node[idxB].U[tn];
+    LoadU(tn, idxB, node, U);
     const Real uB = U[1] / U[0];
     const Real wB = U[3] / U[0];
 
-    U = node[idxE].U[tn];
+    LoadU(tn, idxE, node, U);
     const Real uE = U[1] / U[0];
     const Real vE = U[2] / U[0];
     const Real wE = U[3] / U[0];
     const Real TE = ComputeTemperature(model->cv, U);
 
-    U = node[idxSE].U[tn];
+    LoadU(tn, idxSE, node, U);
     const Real uSE = U[1] / U[0];
     const Real vSE = U[2] / U[0];
 
-    U = node[idxNE].U[tn];
+    LoadU(tn, idxNE, node, U);
     const Real uNE = U[1] / U[0];
     const Real vNE = U[2] / U[0];
 
-    U = node[idxFE].U[tn];
+    LoadU(tn, idxFE, node, U);
     const Real uFE = U[1] / U[0];
     const Real wFE = U[3] / U[0];
 
-    U = node[idxBE].U[tn];
+    LoadU(tn, idxBE, node, U);
     const Real uBE = U[1] / U[0];
     const Real wBE = U[3] / U[0];
 
@@ -140,63 +136,63 @@ static void ComputeFvhatX(const int tn, const int k, const int j, const int i,
     Fvhat[4] = heatK * dT_dx + Fvhat[1] * uhat + Fvhat[2] * vhat + Fvhat[3] * what;
     return;
 }
-static void ComputeFvhatY(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+static void ComputeFvhatY(const int tn, const int idx, const int stride[restrict],
+        const Real dd[restrict], const Node *const node,
         const Model *model, Real Fvhat[restrict])
 {
-    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxW = IndexNode(k, j, i - 1, partn[Y], partn[X]);
-    const int idxE = IndexNode(k, j, i + 1, partn[Y], partn[X]);
-    const int idxF = IndexNode(k - 1, j, i, partn[Y], partn[X]);
-    const int idxB = IndexNode(k + 1, j, i, partn[Y], partn[X]);
-
-    const int idxN = IndexNode(k, j + 1, i, partn[Y], partn[X]);
-    const int idxWN = IndexNode(k, j + 1, i - 1, partn[Y], partn[X]);
-    const int idxEN = IndexNode(k, j + 1, i + 1, partn[Y], partn[X]);
-    const int idxFN = IndexNode(k - 1, j + 1, i, partn[Y], partn[X]);
-    const int idxBN = IndexNode(k + 1, j + 1, i, partn[Y], partn[X]);
-
-    const Real *restrict U = node[idx].U[tn];
+    const int idxW = idx - stride[X];
+    const int idxE = idx + stride[X];
+    const int idxF = idx - stride[Z];
+    const int idxB = idx + stride[Z];
+
+    const int idxN = idx + stride[Y];
+    const int idxWN = idx - stride[X] + stride[Y];
+    const int idxEN = idx + stride[X] + stride[Y];
+    const int idxFN = idx + stride[Y] - stride[Z];
+    const int idxBN = idx + stride[Y] + stride[Z];
+
+    Real U[DIMU];
+    LoadU(tn, idx, node, U);
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
     const Real T = ComputeTemperature(model->cv, U);
 
-    U = node[idxW].U[tn];
+    LoadU(tn, idxW, node, U);
     const Real uW = U[1] / U[0];
     const Real vW = U[2] / U[0];
 
-    U = node[idxE].U[tn];
+    LoadU(tn, idxE, node, U);
     const Real uE = U[1] / U[0];
     const Real vE = U[2] / U[0];
 
-    U = node[idxF].U[tn];
+    LoadU(tn, idxF, node, U);
     const Real vF = U[2] / U[0];
     const Real wF = U[3] / U[0];
 
-    U = node[idxB].U[tn];
+    LoadU(tn, idxB, node, U);
     const Real vB = U[2] / U[0];
     const Real wB = U[3] / U[0];
 
-    U = node[idxN].U[tn];
+    LoadU(tn, idxN, node, U);
     const Real uN = U[1] / U[0];
     const Real vN = U[2] / U[0];
     const Real wN = U[3] / U[0];
     const Real TN = ComputeTemperature(model->cv, U);
 
-    U = node[idxWN].U[tn];
+    LoadU(tn, idxWN, node, U);
     const Real uWN = U[1] / U[0];
     const Real vWN = U[2] / U[0];
 
-    U = node[idxEN].U[tn];
+    LoadU(tn, idxEN, node, U);
     const Real uEN = U[1] / U[0];
     const Real vEN = U[2] / U[0];
 
-    U = node[idxFN].U[tn];
+    LoadU(tn, idxFN, node, U);
     const Real vFN = U[2] / U[0];
     const Real wFN = U[3] / U[0];
 
-    U = node[idxBN].U[tn];
+    LoadU(tn, idxBN, node, U);
     const Real vBN = U[2] / U[0];
     const Real wBN = U[3] / U[0];
 
@@ -225,63 +221,63 @@ static void ComputeFvhatY(const int tn, const int k, const int j, const int i,
     Fvhat[4] = heatK * dT_dy + Fvhat[1] * uhat + Fvhat[2] * vhat + Fvhat[3] * what;
     return ;
 }
-static void ComputeFvhatZ(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+static void ComputeFvhatZ(const int tn, const int idx, const int stride[restrict],
+        const Real dd[restrict], const Node *const node,
         const Model *model, Real Fvhat[restrict])
 {
-    const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxW = IndexNode(k, j, i - 1, partn[Y], partn[X]);
-    const int idxE = IndexNode(k, j, i + 1, partn[Y], partn[X]);
-    const int idxS = IndexNode(k, j - 1, i, partn[Y], partn[X]);
-    const int idxN = IndexNode(k, j + 1, i, partn[Y], partn[X]);
-
-    const int idxB = IndexNode(k + 1, j, i, partn[Y], partn[X]);
-    const int idxWB = IndexNode(k + 1, j, i - 1, partn[Y], partn[X]);
-    const int idxEB = IndexNode(k + 1, j, i + 1, partn[Y], partn[X]);
-    const int idxSB = IndexNode(k + 1, j - 1, i, partn[Y], partn[X]);
-    const int idxNB = IndexNode(k + 1, j + 1, i, partn[Y], partn[X]);
-
-    const Real *restrict U = node[idx].U[tn];
+    const int idxW = idx - stride[X];
+    const int idxE = idx + stride[X];
+    const int idxS = idx - stride[Y];
+    const int idxN = idx + stride[Y];
+
+    const int idxB = idx + stride[Z];
+    const int idxWB = idx - stride[X] + stride[Z];
+    const int idxEB = idx + stride[X] + stride[Z];
+    const int idxSB = idx - stride[Y] + stride[Z];
+    const int idxNB = idx + stride[Y] + stride[Z];
+
+    Real U[DIMU];
+    LoadU(tn, idx, node, U);
     const Real u = U[1] / U[0];
     const Real v = U[2] / U[0];
     const Real w = U[3] / U[0];
     const Real T = ComputeTemperature(model->cv, U);
 
-    U = node[idxW].U[tn];
+    LoadU(tn, idxW, node, U);
     const Real uW = U[1] / U[0];
     const Real wW = U[3] / U[0];
 
-    U = node[idxE].U[tn];
+    LoadU(tn, idxE, node, U);
     const Real uE = U[1] / U[0];
     const Real wE = U[3] / U[0];
 
-    U = node[idxS].U[tn];
+    LoadU(tn, idxS, node, U);
     const Real vS = U[2] / U[0];
     const Real wS = U[3] / U[0];
 
-    U = node[idxN].U[tn];
+    LoadU(tn, idxN, node, U);
     const Real vN = U[2] / U[0];
     const Real wN = U[3] / U[0];
 
-    U = node[idxB].U[tn];
+    LoadU(tn, idxB, node, U);
     const Real uB = U[1] / U[0];
     const Real vB = U[2] / U[0];
     const Real wB = U[3] / U[0];
     const Real TB = ComputeTemperature(model->cv, U);
 
-    U = node[idxWB].U[tn];
+    LoadU(tn, idxWB, node, U);
     const Real uWB = U[1] / U[0];
     const Real wWB = U[3] / U[0];
 
-    U = node[idxEB].U[tn];
+    LoadU(tn, idxEB, node, U);
     const Real uEB = U[1] / U[0];
     const Real wEB = U[3] / U[0];
 
-    U = node[idxSB].U[tn];
+    LoadU(tn, idxSB, node, U);
     const Real vSB = U[2] / U[0];
     const Real wSB = U[3] / U[0];
 
-    U = node[idxNB].U[tn];
+    LoadU(tn, idxNB, node, U);
     const Real vNB = U[2] / U[0];
     const Real wNB = U[3] / U[0];
 
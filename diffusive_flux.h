@@ -27,10 +27,13 @@
  * Diffusive flux
  *
  * Function
- *      Reconstruct the numerical diffusive flux.
+ *      Reconstruct the numerical diffusive flux at the interface between
+ *      node idx and its neighbour in direction s. Neighbours are addressed
+ *      by the index stride of each dimension, so the field data can be
+ *      either the global field or a gathered pencil.
  */
-extern void ComputeFvhat(const int tn, const int s, const int k, const int j,
-        const int i, const int partn[restrict], const Real dd[restrict],
+extern void ComputeFvhat(const int tn, const int s, const int idx,
+        const int stride[restrict], const Real dd[restrict],
         const Node *const, const Model *, Real Fvhat[restrict]);
 #endif
 /* a good practice: end file with a newline */
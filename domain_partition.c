@@ -12,13 +12,20 @@
  * Required Header Files
  ****************************************************************************/
 #include "domain_partition.h"
+#include "data_exchange.h"
+#include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void DecomposeDomain(Partition *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void PartitionDomain(Space *space)
 {
     Partition *const part = &(space->part);
+    DecomposeDomain(part);
     /*
      * Outward facing surface unit normal vector of domain boundary
      * Surface normal vector can provide great advantage: every surface can
@@ -70,6 +77,26 @@ void PartitionDomain(Space *space)
             part->ns[PIN][s][MIN] = part->ng[s] + 1;
             part->ns[PIN][s][MAX] = part->n[s] - part->ng[s] - 1;
         }
+        /* boundaries shared with neighbouring blocks are interior nodes */
+        if (NONE != part->nb[q]) {
+            part->ns[PIN][s][MIN] = part->ng[s];
+        }
+        if (NONE != part->nb[q + 1]) {
+            part->ns[PIN][s][MAX] = part->n[s] - part->ng[s];
+        }
+        /*
+         * exchange region: the interior region extended to the ghost
+         * layers filled by neighbouring blocks, excluding the periodic
+         * wrapping which is not a geometric neighbour.
+         */
+        part->ns[PEX][s][MIN] = part->ns[PIN][s][MIN];
+        part->ns[PEX][s][MAX] = part->ns[PIN][s][MAX];
+        if ((NONE != part->nb[q]) && (0 != part->coord[s])) {
+            part->ns[PEX][s][MIN] = 0;
+        }
+        if ((NONE != part->nb[q + 1]) && (part->proc[s] - 1 != part->coord[s])) {
+            part->ns[PEX][s][MAX] = part->n[s];
+        }
         /* boundary box */
         for (int p = PWB; p <= PBB; ++p) {
             part->ns[p][s][MIN] = part->ng[s];
@@ -148,5 +175,35 @@ void PartitionDomain(Space *space)
     part->pathSep[0] = part->pathSep[part->gl];
     return;
 }
+/*
+ * The global node layers are distributed over the block grid of processors
+ * as evenly as possible, with the leading blocks taking the remainders.
+ * The domain geometry is kept global, and the node index of the global
+ * domain origin is recorded for each block, therefore, the mapping between
+ * coordinates and local node indices is identical to a single block.
+ */
+static void DecomposeDomain(Partition *part)
+{
+    CreateExchangeTopology(part);
+    int M = 0; /* number of global node layers */
+    int ml = 0; /* number of local node layers */
+    int offset = 0; /* global index of the first local node layer */
+    for (int s = 0; s < DIMS; ++s) {
+        part->no[s] = part->ng[s];
+        if (1 == part->proc[s]) {
+            continue;
+        }
+        M = part->m[s] + 1;
+        ml = M / part->proc[s] + (part->coord[s] < M % part->proc[s]);
+        offset = part->coord[s] * (M / part->proc[s]) + MinInt(part->coord[s], M % part->proc[s]);
+        if (part->ng[s] + 1 >= ml) {
+            ShowError("too many processors on dimension %d: %d\n", s, part->proc[s]);
+        }
+        part->m[s] = ml - 1;
+        part->n[s] = ml + 2 * part->ng[s];
+        part->no[s] = part->ng[s] - offset;
+    }
+    return;
+}
 /* a good practice: end file with a newline */
 
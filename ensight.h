@@ -23,18 +23,28 @@
 typedef enum {
     ENSTR = 80, /* string data length */
     ENVARSTR = 10, /* variable name length */
-    ENSCAN = 10, /* maximum number of scalar variables */
+    ENSCAN = 15, /* maximum number of scalar variables */
     ENVECN = 1, /* maximum number of vector variables */
+    ENBUFN = 65536, /* number of values staged for each variable */
 } EnConst;
+typedef enum {
+    ENFIELD = 0, /* field data */
+    ENSTATS = 1, /* field statistics */
+    ENSPH = 2, /* analytical polyhedrons */
+    ENSTL = 3, /* triangulated polyhedrons */
+    ENINDEXN = 4, /* number of transient case file series */
+} EnSeries;
 typedef char EnStr[ENSTR]; /* string data */
 typedef float EnReal; /* real data */
 typedef struct {
     EnStr rname; /* data file root name */
+    int series; /* transient case file series */
     EnStr bname; /* data file base name */
     EnStr fname; /* store current open file name */
     EnStr str; /* string data */
     EnStr fmt; /* format specifier */
     EnStr gtag; /* geometry name tag */
+    EnStr gname; /* root name of a shared geometry file, empty if its own */
     EnStr vtag; /* variable name tag */
     EnStr dtype; /* data type */
     int part[LIMIT]; /* part control */
@@ -42,7 +52,15 @@ typedef struct {
     char sca[ENSCAN][ENVARSTR]; /* scalar variables */
     int vecN; /* number of vector variables */
     char vec[ENVECN][ENVARSTR]; /* vctor variables */
+    const Real *stat; /* running statistics, NULL for the field data */
+    int sampleN; /* number of statistics samples */
 } EnSet; /* configuration structure */
+typedef struct {
+    EnStr rname; /* data file root name, empty if not in use */
+    long count; /* position of the number of steps in the transient case file */
+    long end; /* position of the end of the time values */
+    int stepN; /* number of listed time values */
+} EnIndex; /* transient case file index */
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
@@ -51,6 +69,10 @@ typedef struct {
  */
 extern void WriteStructuredDataEnsight(const Time *, const Space *, const Model *);
 extern void ReadStructuredDataEnsight(Time *, Space *, const Model *);
+/*
+ * Statistics data writer
+ */
+extern void WriteStatisticsDataEnsight(const Time *, const Space *, const Model *);
 /*
  * Poly data writer and reader
  */
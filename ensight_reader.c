@@ -47,6 +47,9 @@ void ReadStructuredDataEnsight(Time *time, Space *space, const Model *model)
         .vecN = 0,
         .vec = {{'\0'}},
     };
+    if (1 < space->part.rankN) { /* a file series for each processor */
+        snprintf(enSet.rname, sizeof(EnStr), "field_%04d_", space->part.rank);
+    }
     snprintf(enSet.bname, sizeof(EnStr), enSet.fmt, enSet.rname, time->dataC);
     ReadCaseFile(time, &enSet);
     ReadStructuredData(space, model, &enSet);
@@ -68,7 +71,7 @@ static void ReadStructuredData(Space *space, const Model *model, EnSet *enSet)
     EnReal data = 0.0; /* the Ensight data format */
     const Partition *const part = &(space->part);
     Node *const node = space->node;
-    Real *restrict U = NULL;
+    Real U[DIMU] = {0.0};
     int idx = 0; /* linear array index math variable */
     for (int s = 0; s < enSet->scaN; ++s) {
         snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->sca[s]);
@@ -84,23 +87,27 @@ static void ReadStructuredData(Space *space, const Model *model, EnSet *enSet)
                         idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
                         if (0 == s) {
                             /* geometric field initializer */
-                            node[idx].did = NONE;
-                            node[idx].fid = NONE;
-                            node[idx].lid = NONE;
-                            node[idx].gst = NONE;
-                            memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
+                            node->did[idx] = NONE;
+                            node->fid[idx] = NONE;
+                            node->lid[idx] = NONE;
+                            node->gst[idx] = NONE;
+                            for (int t = 0; t < node->levelN; ++t) {
+                                for (int n = 0; n < DIMU; ++n) {
+                                    memset(node->U[t][n] + idx, 1, sizeof(Real));
+                                }
+                            }
                             if (InPartBox(k, j, i, part->ns[PIN])) {
-                                node[idx].did = 0;
-                                node[idx].fid = 0;
-                                node[idx].lid = 0;
-                                node[idx].gst = 0;
+                                node->did[idx] = 0;
+                                node->fid[idx] = 0;
+                                node->lid[idx] = 0;
+                                node->gst[idx] = 0;
                             }
                         }
                         if (!InPartBox(k, j, i, part->ns[p])) {
                             continue;
                         }
                         /* data field initializer */
-                        U = node[idx].U[TO];
+                        LoadU(TO, idx, node, U);
                         Fread(&data, sizeof(EnReal), 1, fp);
                         switch (s) {
                             case 0: /* rho */
@@ -122,6 +129,7 @@ static void ReadStructuredData(Space *space, const Model *model, EnSet *enSet)
                             default:
                                 break;
                         }
+                        StoreU(TO, idx, U, node);
                     }
                 }
             }
@@ -203,7 +211,6 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
         Fread(enSet->str, sizeof(EnStr), 1, fp);
         Fread(&ne, sizeof(int), 1, fp);
         AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, poly);
-        poly->edgeN = 0; /* reset edge count before applying edge adding */
         for (int s = 0; s < DIMS; ++s) {
             for (int n = 0; n < poly->vertN; ++n) {
                 Fread(&data, sizeof(EnReal), 1, fp);
@@ -217,11 +224,8 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
                 Fread(&m, sizeof(int), 1, fp);
                 poly->f[n][s] = m - 1;
             }
-            AddEdge(poly->f[n][0], poly->f[n][1], n, poly);
-            AddEdge(poly->f[n][1], poly->f[n][2], n, poly);
-            AddEdge(poly->f[n][2], poly->f[n][0], n, poly);
         }
-        QuickSortEdge(poly->edgeN, poly->e);
+        BuildEdgeList(poly);
     }
     ReadPolyState(pm, pn, geo, enSet);
     return;
@@ -15,15 +15,20 @@
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
 #include "data_stream.h"
+#include "statistics.h"
+#include "computational_geometry.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static void InitializeTransientCaseFile(EnSet *);
+static void InitializeTransientCaseFile(const Time *, EnSet *, EnIndex *);
 static void WriteCaseFile(const Time *, EnSet *);
+static EnIndex *FindIndex(const int);
 static void WriteGeometryFile(const Space *, EnSet *);
 static void WriteStructuredData(const Space *, const Model *, EnSet *);
+static Real ComputeFieldVariable(const int, const Real [restrict], const int, const Model *);
+static void FlushBlock(const int, const int, FILE *[restrict], long [restrict], EnReal [restrict][ENBUFN]);
 static void PointPolyDataWriter(const Time *, const Geometry *const);
 static void WritePointPolyData(const int, const int, const Geometry *const, EnSet *);
 static void PolygonPolyDataWriter(const Time *, const Geometry *const);
@@ -37,6 +42,7 @@ void WriteStructuredDataEnsight(const Time *time, const Space *space, const Mode
 {
     EnSet enSet = { /* initialize environment */
         .rname = "field",
+        .series = ENFIELD,
         .bname = {'\0'},
         .fname = {'\0'},
         .str = {'\0'},
@@ -50,24 +56,70 @@ void WriteStructuredDataEnsight(const Time *time, const Space *space, const Mode
         .vecN = 1,
         .vec = {"Vel"},
     };
+    if (1 < space->part.rankN) { /* a file series for each processor */
+        snprintf(enSet.rname, sizeof(EnStr), "field_%04d_", space->part.rank);
+    }
     snprintf(enSet.bname, sizeof(EnStr), enSet.fmt, enSet.rname, time->dataC);
     if (0 == time->stepC) { /* initialization step */
-        InitializeTransientCaseFile(&enSet);
         WriteGeometryFile(space, &enSet);
     }
     WriteCaseFile(time, &enSet);
     WriteStructuredData(space, model, &enSet);
     return;
 }
-static void InitializeTransientCaseFile(EnSet *enSet)
+void WriteStatisticsDataEnsight(const Time *time, const Space *space, const Model *model)
 {
-    snprintf(enSet->fname, sizeof(EnStr), "%s.case", enSet->rname);
-    FILE *fp = Fopen(enSet->fname, "w");
+    EnSet enSet = { /* initialize environment */
+        .rname = "stats",
+        .series = ENSTATS,
+        .bname = {'\0'},
+        .fname = {'\0'},
+        .str = {'\0'},
+        .fmt = "%s%05d",
+        .gtag = {'\0'},
+        .gname = "field",
+        .vtag = "*****",
+        .dtype = "block",
+        .part = {PIO, PIO + 1},
+        .scaN = 15,
+        .sca = {"rho", "u", "v", "w", "p", "T", "rho_rms", "u_rms", "v_rms", "w_rms", "p_rms", "T_rms",
+            "uv", "uw", "vw"},
+        .vecN = 1,
+        .vec = {"Vel"},
+        .stat = space->node->stat,
+        .sampleN = time->statC,
+    };
+    if (1 < space->part.rankN) { /* a file series for each processor */
+        snprintf(enSet.rname, sizeof(EnStr), "stats_%04d_", space->part.rank);
+        snprintf(enSet.gname, sizeof(EnStr), "field_%04d_", space->part.rank);
+    }
+    snprintf(enSet.bname, sizeof(EnStr), enSet.fmt, enSet.rname, time->dataC);
+    /* the geometry file of the field data is shared */
+    WriteCaseFile(time, &enSet);
+    WriteStructuredData(space, model, &enSet);
+    return;
+}
+/*
+ * The transient case file lists the exports before the current one, taken
+ * from their own case files. Hence a restart drops exports after the
+ * restart point, and a transient case file damaged by an interrupted run
+ * is repaired. It is written to a temporary file and then renamed.
+ */
+static void InitializeTransientCaseFile(const Time *time, EnSet *enSet, EnIndex *index)
+{
+    String str = {'\0'}; /* store the current read line */
+    String tname = {'\0'}; /* temporary file name */
+    String fname = {'\0'}; /* case file name of an earlier export */
+    EnStr bname = {'\0'}; /* base name of an earlier export */
+    EnStr now = {'\0'}; /* time value of an earlier export */
+    snprintf(index->rname, sizeof(EnStr), "%s", enSet->rname);
+    snprintf(tname, sizeof tname, "%s.tmp", enSet->rname);
+    FILE *fp = Fopen(tname, "w");
     fprintf(fp, "FORMAT\n");
     fprintf(fp, "type: ensight gold\n");
     fprintf(fp, "\n");
     fprintf(fp, "GEOMETRY\n");
-    fprintf(fp, "model: %s%s.geo\n", enSet->rname, enSet->gtag);
+    fprintf(fp, "model: %s%s.geo\n", ('\0' == *enSet->gname) ? enSet->rname : enSet->gname, enSet->gtag);
     fprintf(fp, "\n");
     fprintf(fp, "VARIABLE\n");
     for (int n = 0; n < enSet->scaN; ++n) {
@@ -81,11 +133,43 @@ static void InitializeTransientCaseFile(EnSet *enSet)
     fprintf(fp, "\n");
     fprintf(fp, "TIME\n");
     fprintf(fp, "time set: 1\n");
-    fprintf(fp, "number of steps:          0          \n");
+    fprintf(fp, "number of steps:          ");
+    index->count = ftell(fp);
+    fprintf(fp, "%-10d \n", 0);
     fprintf(fp, "filename start number:    0\n");
     fprintf(fp, "filename increment:       1\n");
     fprintf(fp, "time values:  ");
+    /* file names follow the time values, so the list stops at a gap */
+    for (index->stepN = 0; index->stepN < time->dataC; ++index->stepN) {
+        snprintf(bname, sizeof(EnStr), enSet->fmt, enSet->rname, index->stepN);
+        snprintf(fname, sizeof fname, "%s.case", bname);
+        FILE *fc = fopen(fname, "r");
+        if (NULL == fc) {
+            break;
+        }
+        now[0] = '\0';
+        while (NULL != fgets(str, sizeof str, fc)) {
+            if (1 == sscanf(str, "constant per case: Time %79s", now)) {
+                break;
+            }
+        }
+        fclose(fc);
+        if ('\0' == now[0]) {
+            break;
+        }
+        if ((index->stepN % 5) == 0) { /* print to a new line every x outputs */
+            fprintf(fp, "\n");
+        }
+        fprintf(fp, "%s ", now);
+    }
+    index->end = ftell(fp);
+    fseek(fp, index->count, SEEK_SET);
+    fprintf(fp, "%d", index->stepN);
     fclose(fp);
+    snprintf(fname, sizeof fname, "%s.case", enSet->rname);
+    if (0 != rename(tname, fname)) {
+        ShowError("failed to rename file: %s", tname);
+    }
     return;
 }
 static void WriteCaseFile(const Time *time, EnSet *enSet)
@@ -96,7 +180,9 @@ static void WriteCaseFile(const Time *time, EnSet *enSet)
     fprintf(fp, "type: ensight gold\n");
     fprintf(fp, "\n");
     fprintf(fp, "GEOMETRY\n");
-    if ('\0' == *enSet->gtag) {
+    if ('\0' != *enSet->gname) {
+        fprintf(fp, "model: %s.geo\n", enSet->gname);
+    } else if ('\0' == *enSet->gtag) {
         fprintf(fp, "model: %s.geo\n", enSet->rname);
     } else {
         fprintf(fp, "model: %s.geo\n", enSet->bname);
@@ -115,21 +201,45 @@ static void WriteCaseFile(const Time *time, EnSet *enSet)
     }
     fprintf(fp, "\n");
     fclose(fp);
-    /* add case to the transient case file */
+    /* add case to the transient case file, the first export of a run builds it */
+    EnIndex *index = FindIndex(enSet->series);
+    if ('\0' == index->rname[0]) {
+        InitializeTransientCaseFile(time, enSet, index);
+    }
     snprintf(enSet->fname, sizeof(EnStr), "%s.case", enSet->rname);
     fp = Fopen(enSet->fname, "r+");
-    /* seek the target line for adding information */
-    ReadInLine(fp, "time set: 1");
-    fprintf(fp, "number of steps:          %d", (time->dataC + 1));
-    /* add the time flag of current export to the transient case */
-    fseek(fp, 0, SEEK_END); /* seek to the end of file */
-    if ((time->dataC % 5) == 0) { /* print to a new line every x outputs */
+    /*
+     * Append the time value at the recorded end and then update the number
+     * of steps in its fixed width field, rather than searching the file, so
+     * adding an export costs the same however many exports are listed. An
+     * interruption in between leaves a valid file missing the last export.
+     */
+    fseek(fp, index->end, SEEK_SET);
+    if ((index->stepN % 5) == 0) { /* print to a new line every x outputs */
         fprintf(fp, "\n");
     }
     fprintf(fp, "%.6g ", time->now);
+    index->end = ftell(fp);
+    ++index->stepN;
+    fflush(fp);
+    fseek(fp, index->count, SEEK_SET);
+    fprintf(fp, "%d", index->stepN);
     fclose(fp);
     return;
 }
+/*
+ * Return the index of the transient case file of a series, which is not
+ * in use until the file is built. Each series has its own index, so a
+ * new series only needs to be added to the series enumeration.
+ */
+static EnIndex *FindIndex(const int series)
+{
+    static EnIndex index[ENINDEXN]; /* indices of transient case files */
+    if ((0 > series) || (ENINDEXN <= series)) {
+        ShowError("unknown transient case file series: %d", series);
+    }
+    return index + series;
+}
 static void WriteGeometryFile(const Space *space, EnSet *enSet)
 {
     /*
@@ -138,9 +248,12 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
      */
     snprintf(enSet->fname, sizeof(EnStr), "%s.geo", enSet->rname);
     FILE *fp = Fopen(enSet->fname, "wb");
-    EnReal data = 0.0; /* the Ensight data format */
     const Partition *const part = &(space->part);
+    FILE *fpc[DIMS] = {fp, fp, fp}; /* file of each coordinate */
+    long offset[DIMS] = {0}; /* write position of each coordinate */
+    EnReal (*block)[ENBUFN] = AssignStorage(DIMS * sizeof(*block)); /* staged coordinates */
     IntVec ne = {0}; /* i, j, k node number in each part */
+    int m = 0; /* number of staged values */
     /* description at the beginning */
     strncpy(enSet->str, "C Binary", sizeof(EnStr));
     fwrite(enSet->str, sizeof(EnStr), 1, fp);
@@ -154,6 +267,7 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
     strncpy(enSet->str, "element id off", sizeof(EnStr));
     fwrite(enSet->str, sizeof(EnStr), 1, fp);
     for (int p = enSet->part[MIN], pnum = 1; p < enSet->part[MAX]; ++p, ++pnum) {
+        fseek(fp, 0, SEEK_END);
         strncpy(enSet->str, "part", sizeof(EnStr));
         fwrite(enSet->str, sizeof(EnStr), 1, fp);
         fwrite(&pnum, sizeof(int), 1, fp);
@@ -165,18 +279,28 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
         ne[Y] = part->ns[p][Y][MAX] - part->ns[p][Y][MIN];
         ne[Z] = part->ns[p][Z][MAX] - part->ns[p][Z][MIN];
         fwrite(ne, sizeof(int), 3, fp);
+        /* coordinates are written in blocks of x, y, and z in turn */
         for (int s = 0; s < DIMS; ++s) {
-            for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                    for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                        ne[X] = i; ne[Y] = j; ne[Z] = k;
-                        data = MapPoint(ne[s], part->domain[s][MIN], part->d[s], part->ng[s]);
-                        fwrite(&data, sizeof(EnReal), 1, fp);
+            offset[s] = ftell(fp) + (long)s * ne[X] * ne[Y] * ne[Z] * sizeof(EnReal);
+        }
+        for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
+            for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
+                for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
+                    block[X][m] = MapPoint(i, part->domain[X][MIN], part->d[X], part->no[X]);
+                    block[Y][m] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->no[Y]);
+                    block[Z][m] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->no[Z]);
+                    ++m;
+                    if (ENBUFN == m) {
+                        FlushBlock(DIMS, m, fpc, offset, block);
+                        m = 0;
                     }
                 }
             }
         }
+        FlushBlock(DIMS, m, fpc, offset, block);
+        m = 0;
     }
+    RetrieveStorage(block);
     fclose(fp);
     return;
 }
@@ -184,92 +308,131 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
  * The values for each node of the structured block are output in
  * the same IJK order as the coordinates. (The number of nodes in the
  * part are obtained from the corresponding geometry file.)
+ *
+ * All variables are derived in a single traversal of the part. Values are
+ * staged in a block for each scalar and each vector component, and blocks
+ * are written to the position of the variable in its file when full. The
+ * blocks of the scaN scalars come first, followed by the x, y, and z
+ * blocks of each of the vecN vectors. Vector s is formed by the scalars
+ * 1 + DIMS * s to DIMS * (s + 1), i.e., the velocity by u, v, and w.
  */
 static void WriteStructuredData(const Space *space, const Model *model, EnSet *enSet)
 {
-    FILE *fp = NULL;
-    EnReal data = 0.0; /* the Ensight data format */
     const Partition *const part = &(space->part);
     const Node *const node = space->node;
-    const Real *restrict U = NULL;
+    const int varN = enSet->scaN + DIMS * enSet->vecN; /* scalars and vector components */
+    FILE *fp[ENSCAN + DIMS * ENVECN] = {NULL}; /* file of each variable */
+    long offset[ENSCAN + DIMS * ENVECN] = {0}; /* write position of each variable */
+    EnReal (*block)[ENBUFN] = AssignStorage(varN * sizeof(*block)); /* staged variables */
+    Real U[DIMU] = {0.0};
+    const Real *stat = NULL; /* running statistics of a node */
     int idx = 0; /* linear array index math variable */
+    int m = 0; /* number of staged values */
+    long nodeN = 0; /* number of nodes in a part */
     for (int s = 0; s < enSet->scaN; ++s) {
         snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->sca[s]);
-        fp = Fopen(enSet->fname, "wb");
+        fp[s] = Fopen(enSet->fname, "wb");
         /* first line description per file */
         strncpy(enSet->str, "scalar variable", sizeof(EnStr));
-        fwrite(enSet->str, sizeof(EnStr), 1, fp);
-        for (int p = enSet->part[MIN], pnum = 1; p < enSet->part[MAX]; ++p, ++pnum) {
-            /* binary file format */
-            strncpy(enSet->str, "part", sizeof(EnStr));
-            fwrite(enSet->str, sizeof(EnStr), 1, fp);
-            fwrite(&pnum, sizeof(int), 1, fp);
-            strncpy(enSet->str, enSet->dtype, sizeof(EnStr));
-            fwrite(enSet->str, sizeof(EnStr), 1, fp);
-            /* now output the scalar value at each node in current part */
-            for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                    for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        U = node[idx].U[TO];
-                        switch (s) {
-                            case 0: /* rho */
-                                data = U[0];
-                                break;
-                            case 1: /* u */
-                                data = U[1] / U[0];
-                                break;
-                            case 2: /* v */
-                                data = U[2] / U[0];
-                                break;
-                            case 3: /* w */
-                                data = U[3] / U[0];
-                                break;
-                            case 4: /* p */
-                                data = ComputePressure(model->gamma, U);
-                                break;
-                            case 5: /* T */
-                                data = ComputeTemperature(model->cv, U);
-                                break;
-                            case 6: /* node flag */
-                                data = node[idx].did;
-                                break;
-                            default:
-                                break;
-                        }
-                        fwrite(&data, sizeof(EnReal), 1, fp);
-                    }
-                }
-            }
-        }
-        fclose(fp);
+        fwrite(enSet->str, sizeof(EnStr), 1, fp[s]);
     }
     for (int s = 0; s < enSet->vecN; ++s) {
         snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->vec[s]);
-        fp = Fopen(enSet->fname, "wb");
+        fp[enSet->scaN + DIMS * s] = Fopen(enSet->fname, "wb");
         /* binary file format */
         strncpy(enSet->str, "vector variable", sizeof(EnStr));
-        fwrite(enSet->str, sizeof(EnStr), 1, fp);
-        for (int p = enSet->part[MIN], pnum = 1; p < enSet->part[MAX]; ++p, ++pnum) {
+        fwrite(enSet->str, sizeof(EnStr), 1, fp[enSet->scaN + DIMS * s]);
+        /* components share the file of a vector */
+        fp[enSet->scaN + DIMS * s + Y] = fp[enSet->scaN + DIMS * s];
+        fp[enSet->scaN + DIMS * s + Z] = fp[enSet->scaN + DIMS * s];
+    }
+    for (int p = enSet->part[MIN], pnum = 1; p < enSet->part[MAX]; ++p, ++pnum) {
+        nodeN = (long)(part->ns[p][X][MAX] - part->ns[p][X][MIN]) *
+            (part->ns[p][Y][MAX] - part->ns[p][Y][MIN]) * (part->ns[p][Z][MAX] - part->ns[p][Z][MIN]);
+        for (int v = 0; v < varN; ++v) {
+            if ((enSet->scaN <= v) && (0 != (v - enSet->scaN) % DIMS)) {
+                /* vector components are written in blocks of x, y, and z in turn */
+                offset[v] = offset[v - 1] + nodeN * sizeof(EnReal);
+                continue;
+            }
+            /* binary file format */
+            fseek(fp[v], 0, SEEK_END);
             strncpy(enSet->str, "part", sizeof(EnStr));
-            fwrite(enSet->str, sizeof(EnStr), 1, fp);
-            fwrite(&pnum, sizeof(int), 1, fp);
+            fwrite(enSet->str, sizeof(EnStr), 1, fp[v]);
+            fwrite(&pnum, sizeof(int), 1, fp[v]);
             strncpy(enSet->str, enSet->dtype, sizeof(EnStr));
-            fwrite(enSet->str, sizeof(EnStr), 1, fp);
-            for (int n = 1; n < 4; ++n) {
-                for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                    for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                        for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                            idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                            U = node[idx].U[TO];
-                            data = U[n] / U[0];
-                            fwrite(&data, sizeof(EnReal), 1, fp);
+            fwrite(enSet->str, sizeof(EnStr), 1, fp[v]);
+            offset[v] = ftell(fp[v]);
+        }
+        /* now output the variables at each node in current part */
+        for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
+            for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
+                for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    if (NULL != enSet->stat) { /* statistics, the vector is the mean velocity */
+                        stat = enSet->stat + (size_t)idx * DIMSTAT;
+                        for (int v = 0; v < enSet->scaN; ++v) {
+                            block[v][m] = ComputeStatistic(v, enSet->sampleN, stat);
+                        }
+                    } else {
+                        LoadU(TO, idx, node, U);
+                        for (int v = 0; v < enSet->scaN; ++v) {
+                            block[v][m] = ComputeFieldVariable(v, U, node->did[idx], model);
                         }
                     }
+                    for (int v = enSet->scaN; v < varN; ++v) {
+                        block[v][m] = block[1 + v - enSet->scaN][m];
+                    }
+                    ++m;
+                    if (ENBUFN == m) {
+                        FlushBlock(varN, m, fp, offset, block);
+                        m = 0;
+                    }
                 }
             }
         }
-        fclose(fp);
+        FlushBlock(varN, m, fp, offset, block);
+        m = 0;
+    }
+    for (int v = 0; v < varN; ++v) {
+        if ((enSet->scaN > v) || (0 == (v - enSet->scaN) % DIMS)) {
+            fclose(fp[v]);
+        }
+    }
+    RetrieveStorage(block);
+    return;
+}
+/*
+ * Return field variable s of a node: rho, u, v, w, p, T, and the node
+ * flag for s in [0, 6], in the order of the scalars of the field data.
+ */
+static Real ComputeFieldVariable(const int s, const Real U[restrict], const int did, const Model *model)
+{
+    switch (s) {
+        case 0: /* rho */
+            return U[0];
+        case 1: /* u */
+        case 2: /* v */
+        case 3: /* w */
+            return U[s] / U[0];
+        case 4: /* p */
+            return ComputePressure(model->gamma, U);
+        case 5: /* T */
+            return ComputeTemperature(model->cv, U);
+        default: /* node flag */
+            return did;
+    }
+}
+/*
+ * Write staged values of each variable to its position in file.
+ */
+static void FlushBlock(const int varN, const int n, FILE *fp[restrict], long offset[restrict],
+        EnReal block[restrict][ENBUFN])
+{
+    for (int v = 0; v < varN; ++v) {
+        fseek(fp[v], offset[v], SEEK_SET);
+        fwrite(block[v], sizeof(EnReal), n, fp[v]);
+        offset[v] = offset[v] + n * sizeof(EnReal);
     }
     return;
 }
@@ -287,6 +450,7 @@ static void PointPolyDataWriter(const Time *time, const Geometry *const geo)
 {
     EnSet enSet = { /* initialize environment */
         .rname = "geo_sph",
+        .series = ENSPH,
         .bname = {'\0'},
         .fname = {'\0'},
         .str = {'\0'},
@@ -301,9 +465,6 @@ static void PointPolyDataWriter(const Time *time, const Geometry *const geo)
         .vec = {"Vel"},
     };
     snprintf(enSet.bname, sizeof(EnStr), enSet.fmt, enSet.rname, time->dataC);
-    if (0 == time->stepC) { /* initialization step */
-        InitializeTransientCaseFile(&enSet);
-    }
     WriteCaseFile(time, &enSet);
     WritePointPolyData(0, geo->sphN, geo, &enSet);
     return;
@@ -359,6 +520,7 @@ static void PolygonPolyDataWriter(const Time *time, const Geometry *const geo)
 {
     EnSet enSet = { /* initialize environment */
         .rname = "geo_stl",
+        .series = ENSTL,
         .bname = {'\0'},
         .fname = {'\0'},
         .str = {'\0'},
@@ -373,9 +535,6 @@ static void PolygonPolyDataWriter(const Time *time, const Geometry *const geo)
         .vec = {{'\0'}},
     };
     snprintf(enSet.bname, sizeof(EnStr), enSet.fmt, enSet.rname, time->dataC);
-    if (0 == time->stepC) { /* initialization step */
-        InitializeTransientCaseFile(&enSet);
-    }
     WriteCaseFile(time, &enSet);
     WritePolygonPolyData(geo->sphN, geo->totN, geo, &enSet);
     return;
@@ -385,6 +544,7 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
     snprintf(enSet->fname, sizeof(EnStr), "%s.geo", enSet->bname);
     FILE *fp = Fopen(enSet->fname, "wb");
     EnReal data = 0.0; /* the Ensight data format */
+    RealVec pw = {0.0}; /* vertex in world frame */
     const Polyhedron *poly = NULL;
     int ne = 0; /* total number of nodes in a part */
     /* description at the beginning */
@@ -413,7 +573,8 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
         fwrite(&ne, sizeof(int), 1, fp);
         for (int s = 0; s < DIMS; ++s) {
             for (int n = 0; n < poly->vertN; ++n) {
-                data = poly->v[n][s];
+                TransformToWorld(poly, poly->v[n], pw);
+                data = pw[s];
                 fwrite(&data, sizeof(EnReal), 1, fp);
             }
         }
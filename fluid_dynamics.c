@@ -18,6 +18,12 @@
 #include "boundary_treatment.h"
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    PENN = 9, /* number of lines stored in a pencil: 3 x 3 transverse block */
+} FluidConst;
 /****************************************************************************
  * Function Pointers
  ****************************************************************************/
@@ -28,19 +34,28 @@ typedef void (*TimeIntegrator)(const Real, const int, Space *, const Model *);
 static void DiscretizeTime(const Real, const int, Space *, const Model *);
 static void RungeKutta2(const Real, const int, Space *, const Model *);
 static void RungeKutta3(const Real, const int, Space *, const Model *);
+static void LowStorageRungeKutta3(const Real, const int, Space *, const Model *);
+static void LowStorageRungeKutta4(const Real, const int, Space *, const Model *);
+static void LowStorageRungeKutta(const int, const Real [restrict], const Real [restrict],
+        const Real, const int, Space *, const Model *);
+static void UpdateLowStorage(const Real, const int, const int, Space *);
 static void LLLU(const Real, const Real, const Real, const int,
         const int, const int, const int, Space *, const Model *);
+static void GatherPencil(const int, const int, const int, const int, const int,
+        const Partition *const, const Node *const, Node *const);
 static void LU(const Real [restrict], const Real [restrict],
         const Real [restrict], const Real [restrict], Real [restrict]);
 static void SolveOperator(const int, const int, const Real, const Real,
-        const Real [restrict], const Real [restrict], Real [restrict], const Real,
+        const int, const int, const int, const int, Node *const, const Real,
         const Real [restrict]);
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
-static TimeIntegrator IntegrateTime[2] = {
+static TimeIntegrator IntegrateTime[4] = {
     RungeKutta2,
-    RungeKutta3};
+    RungeKutta3,
+    LowStorageRungeKutta3,
+    LowStorageRungeKutta4};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -146,6 +161,81 @@ static void RungeKutta3(const Real dt, const int s, Space *space, const Model *m
     TreatBoundary(TO, space, model);
     return;
 }
+/*
+ * Williamson's three-stage third-order 2N-storage scheme.
+ */
+static void LowStorageRungeKutta3(const Real dt, const int s, Space *space, const Model *model)
+{
+    const Real A[3] = {0.0, -5.0/9.0, -153.0/128.0};
+    const Real B[3] = {1.0/3.0, 15.0/16.0, 8.0/15.0};
+    LowStorageRungeKutta(3, A, B, dt, s, space, model);
+    return;
+}
+/*
+ * Carpenter and Kennedy's five-stage fourth-order 2N-storage scheme.
+ */
+static void LowStorageRungeKutta4(const Real dt, const int s, Space *space, const Model *model)
+{
+    const Real A[5] = {
+        0.0,
+        -567301805773.0/1357537059087.0,
+        -2404267990393.0/2016746695238.0,
+        -3550918686646.0/2091501179385.0,
+        -1275806237668.0/842570457699.0};
+    const Real B[5] = {
+        1432997174477.0/9575080441755.0,
+        5161836677717.0/13612068292357.0,
+        1720146321549.0/2090206949498.0,
+        3134564353537.0/4481467310338.0,
+        2277821191437.0/14882151754819.0};
+    LowStorageRungeKutta(5, A, B, dt, s, space, model);
+    return;
+}
+/*
+ * 2N-storage Runge-Kutta schemes only keep the solution U at TO and the
+ * increment dU at TN. Each stage solves
+ * dU = A * dU + dt * LU; U = U + B * dU.
+ * The increment is not a solution state, hence only TO receives boundary
+ * treatment. A vanishing first coefficient makes the initial dU irrelevant.
+ */
+static void LowStorageRungeKutta(const int stageN, const Real A[restrict], const Real B[restrict],
+        const Real dt, const int s, Space *space, const Model *model)
+{
+    for (int m = 0; m < stageN; ++m) {
+        LLLU(dt, A[m], 1.0, NONE, TO, TN, s, space, model);
+        UpdateLowStorage(B[m], TO, TN, space);
+        TreatBoundary(TO, space, model);
+    }
+    return;
+}
+static void UpdateLowStorage(const Real coeB, const int to, const int tn, Space *space)
+{
+    const Partition *const part = &(space->part);
+    Node *const node = space->node;
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            int idx = 0; /* linear array index math variable */
+            Real U[DIMU] = {0.0};
+            Real dU[DIMU] = {0.0};
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != node->did[idx]) {
+                    continue;
+                }
+                LoadU(to, idx, node, U);
+                LoadU(tn, idx, node, dU);
+                for (int n = 0; n < DIMU; ++n) {
+                    U[n] = U[n] + coeB * dU[n];
+                }
+                StoreU(to, idx, U, node);
+            }
+        }
+    }
+    return;
+}
 /*
  * Spatial operator computation.
  * LLLU = coeA * Un + coeB * LLU; LLU = (I + dt*L)U; L = {Ls, phi}; s = X, Y, Z.
@@ -159,17 +249,9 @@ static void LLLU(const Real dt, const Real coeA, const Real coeB, const int to,
 {
     const Partition *const part = &(space->part);
     Node *const node = space->node;
-    int idx = 0; /* linear array index math variable */
-    int i = 0, j = 0, k = 0; /* index with normal order */
-    const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    Real RHS[5][DIMU] = {{0.0}}; /* spatial operator */
-    Real *restrict FhatR = RHS[0]; /* reconstructed numerical convective flux vector */
-    Real *restrict FhatL = RHS[1]; /* reconstructed numerical convective flux vector */
-    Real *restrict FvhatR = RHS[2]; /* reconstructed numerical diffusive flux vector */
-    Real *restrict FvhatL = RHS[3]; /* reconstructed numerical diffusive flux vector */
-    Real *restrict Phi = RHS[4]; /* right hand side vector */
-    Real *temp = NULL;
     const IntVec partn = {part->n[X], part->n[Y], part->n[Z]};
+    const IntVec stride = {1, partn[X], partn[X] * partn[Y]}; /* index stride of each dimension */
+    const int lineN = (0.0 < model->refMu) ? 5 : 1; /* pencil lines needed by flux kernels */
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
     const RealVec r = {dt * dd[X], dt * dd[Y], dt * dd[Z]};
     int s = 0, sN = 0; /* space sweep control for the operator p */
@@ -184,58 +266,142 @@ static void LLLU(const Real dt, const Real coeA, const Real coeB, const int to,
             s = p; sN = s + 1;
             break;
     }
-    /* space sweep with dimension priority */
+    /*
+     * space sweep with dimension priority
+     * Pencils of a sweep are mutually independent: each one only reads the tn
+     * level and writes its own nodes. Hence they are distributed over threads
+     * with thread private flux buffers and flux inheritance state, and the
+     * result is bitwise identical to the serial sweep.
+     * Y and Z sweeps walk the field arrays with a large stride. Their pencils
+     * are first gathered into a contiguous thread private buffer on which the
+     * flux kernels run, while the update is scattered back to the field.
+     * Convective fluxes of each fluid segment of a pencil are computed by a
+     * single batched call when the segment is entered.
+     */
     for (; s < sN; ++s) {
-        for (int ks = part->np[s][Z][MIN]; ks < part->np[s][Z][MAX]; ++ks) {
-            for (int js = part->np[s][Y][MIN]; js < part->np[s][Y][MAX]; ++js) {
-                for (int is = part->np[s][X][MIN], state = 0; is < part->np[s][X][MAX]; ++is) {
-                    switch (s) {
-                        case X:
-                            i = is; j = js; k = ks;
-                            break;
-                        case Y:
-                            i = js; j = is; k = ks;
-                            break;
-                        case Z:
-                            i = js; j = ks; k = is;
-                            break;
-                        default:
-                            break;
-                    }
-                    idx = IndexNode(k, j, i, partn[Y], partn[X]);
-                    if (0 != node[idx].did) {
-                        state = 0; /* mark domain change and boundary occurrence */
-                        continue;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            Node pen = {NULL}; /* pencil gathered along s */
+            Real *buf = NULL;
+            Real (*Fhat)[DIMU] = AssignStorage(partn[s] * sizeof(*Fhat)); /* convective flux of a fluid segment */
+            const Node *field = node; /* field data read by flux kernels */
+            const int *hs = stride; /* index stride of field */
+            IntVec pstride = {0}; /* index stride of pencil */
+            int base = 0; /* pencil index offset of the sweep line */
+            if (X != s) {
+                buf = AssignStorage(DIMU * PENN * partn[s] * sizeof(*buf));
+                for (int n = 0; n < DIMU; ++n) {
+                    pen.U[tn][n] = buf + n * PENN * partn[s];
+                }
+                pstride[s] = 1;
+                pstride[X] = partn[s];
+                pstride[(Y == s) ? Z : Y] = 3 * partn[s];
+                base = pstride[X] + pstride[(Y == s) ? Z : Y];
+                field = &pen;
+                hs = pstride;
+            }
+#ifdef _OPENMP
+#pragma omp for collapse(2) schedule(static)
+#endif
+            for (int ks = part->np[s][Z][MIN]; ks < part->np[s][Z][MAX]; ++ks) {
+                for (int js = part->np[s][Y][MIN]; js < part->np[s][Y][MAX]; ++js) {
+                    int idx = 0; /* linear array index math variable */
+                    int idxf = 0; /* index of current node in field */
+                    int i = 0, j = 0, k = 0; /* index with normal order */
+                    int segS = 0, segN = 0; /* start and number of nodes of a fluid segment */
+                    Real RHS[3][DIMU] = {{0.0}}; /* spatial operator */
+                    Real *restrict FvhatR = RHS[0]; /* reconstructed numerical diffusive flux vector */
+                    Real *restrict FvhatL = RHS[1]; /* reconstructed numerical diffusive flux vector */
+                    Real *restrict Phi = RHS[2]; /* right hand side vector */
+                    Real *temp = NULL;
+                    if (field == &pen) {
+                        GatherPencil(tn, s, ks, js, lineN, part, node, &pen);
                     }
-                    switch (p) {
-                        case PHI:
-                            ComputePhi(tn, k, j, i, partn, node, model, Phi);
-                            SolveOperator(OPTSPLIT, s, coeA, coeB, node[idx].U[to], node[idx].U[tn], node[idx].U[tm], dt, Phi);
+                    for (int is = part->np[s][X][MIN], state = 0; is < part->np[s][X][MAX]; ++is) {
+                        switch (s) {
+                            case X:
+                                i = is; j = js; k = ks;
+                                break;
+                            case Y:
+                                i = js; j = is; k = ks;
+                                break;
+                            case Z:
+                                i = js; j = ks; k = is;
+                                break;
+                            default:
+                                break;
+                        }
+                        idx = IndexNode(k, j, i, partn[Y], partn[X]);
+                        idxf = (field == &pen) ? base + is : idx;
+                        if (0 != node->did[idx]) {
+                            state = 0; /* mark domain change and boundary occurrence */
                             continue;
-                        default:
-                            break;
-                    }
-                    switch (state) {
-                        case 1: /* inherit numerical flux from the previous node */
-                            temp = FhatL;
-                            FhatL = FhatR;
-                            FhatR = temp;
-                            temp = FvhatL;
-                            FvhatL = FvhatR;
-                            FvhatR = temp;
-                            break;
-                        default: /* compute numerical flux at left interface */
-                            ComputeFhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, node, model, FhatL);
-                            ComputeFvhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, dd, node, model, FvhatL);
-                            state = 1;
-                            break;
+                        }
+                        switch (p) {
+                            case PHI:
+                                ComputePhi(tn, k, j, i, partn, node, model, Phi);
+                                SolveOperator(OPTSPLIT, s, coeA, coeB, to, tn, tm, idx, node, dt, Phi);
+                                continue;
+                            default:
+                                break;
+                        }
+                        switch (state) {
+                            case 1: /* inherit numerical flux from the previous node */
+                                temp = FvhatL;
+                                FvhatL = FvhatR;
+                                FvhatR = temp;
+                                break;
+                            default: /* compute numerical flux at all interfaces of the fluid segment */
+                                segS = is;
+                                segN = 1;
+                                while ((is + segN < part->np[s][X][MAX]) &&
+                                        (0 == node->did[idx + segN * stride[s]])) {
+                                    ++segN;
+                                }
+                                ComputeFhatLine(tn, s, idxf - hs[s], segN + 1, hs, field, model, Fhat);
+                                ComputeFvhat(tn, s, idxf - hs[s], hs, dd, field, model, FvhatL);
+                                state = 1;
+                                break;
+                        }
+                        ComputeFvhat(tn, s, idxf, hs, dd, field, model, FvhatR);
+                        LU(Fhat[is-segS+1], Fhat[is-segS], FvhatR, FvhatL, Phi);
+                        SolveOperator(model->multidim, s, coeA, coeB, to, tn, tm, idx, node, r[s], Phi);
                     }
-                    ComputeFhat(tn, s, k, j, i, partn, node, model, FhatR);
-                    ComputeFvhat(tn, s, k, j, i, partn, dd, node, model, FvhatR);
-                    LU(FhatR, FhatL, FvhatR, FvhatL, Phi);
-                    SolveOperator(model->multidim, s, coeA, coeB, node[idx].U[to], node[idx].U[tn], node[idx].U[tm], r[s], Phi);
                 }
             }
+            RetrieveStorage(buf);
+            RetrieveStorage(Fhat);
+        }
+    }
+    return;
+}
+/*
+ * Gather the field data at time level tn of the sweep line (ks, js) of
+ * direction s into a pencil. The sweep line is the center of a 3 x 3 block
+ * of lines, and lineN > 1 also gathers its four transverse neighbours used
+ * by the diffusive flux. Following the dimension priority of np, js runs
+ * in the x direction and ks runs in the remaining one.
+ */
+static void GatherPencil(const int tn, const int s, const int ks, const int js, const int lineN,
+        const Partition *const part, const Node *const node, Node *const pen)
+{
+    const int line[5][2] = {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}}; /* transverse offsets */
+    const IntVec stride = {1, part->n[X], part->n[X] * part->n[Y]};
+    const int dk = (Y == s) ? Z : Y; /* dimension of ks */
+    const int L = part->n[s];
+    const Real *restrict Uf = NULL;
+    Real *restrict Up = NULL;
+    for (int m = 0; m < lineN; ++m) {
+        const int idx = (ks + line[m][1]) * stride[dk] + (js + line[m][0]) * stride[X];
+        const int idxp = ((1 + line[m][1]) * 3 + (1 + line[m][0])) * L;
+        for (int n = 0; n < DIMU; ++n) {
+            Uf = node->U[tn][n] + idx;
+            Up = pen->U[tn][n] + idxp;
+            for (int a = 0; a < L; ++a) {
+                Up[a] = Uf[a * stride[s]];
+            }
         }
     }
     return;
@@ -249,27 +415,44 @@ static void LU(const Real FhatR[restrict], const Real FhatL[restrict],
     return;
 }
 /*
- * Solve the solution operator for time integration.
- * Note: Uo, Un, and Um are all restricted pointers. Under the condition that
- * Un and Um NEVER alias each other, Uo and Un may alias safely since they only
- * read elements and never modify any elements. Uo and Um may alias safely
- * since Uo only fetch the single element that Um modifies later.
+ * Solve the solution operator for time integration at node idx.
+ * Note: the time levels to and tn may coincide with each other or with tm
+ * since the node data are gathered into local vectors before tm is updated.
+ * A NONE level to marks the increment register of low-storage schemes:
+ * Um = coeA * Um + coeB * r * Phi.
  */
 static void SolveOperator(const int p, const int s, const Real coeA, const Real coeB,
-        const Real Uo[restrict], const Real Un[restrict], Real Um[restrict], const Real r,
-        const Real Phi[restrict])
+        const int to, const int tn, const int tm, const int idx, Node *const node,
+        const Real r, const Real Phi[restrict])
 {
+    Real Uo[DIMU];
+    Real Un[DIMU];
+    Real Um[DIMU];
     /* accumulation step for operator-by-operator approximation */
     if ((OPTBYOPT == p) && (X != s)) {
+        LoadU(tm, idx, node, Um);
         for (int n = 0; n < DIMU; ++n) {
             Um[n] = Um[n] + coeB * r * Phi[n];
         }
+        StoreU(tm, idx, Um, node);
+        return;
+    }
+    /* increment step for low-storage schemes */
+    if (NONE == to) {
+        LoadU(tm, idx, node, Um);
+        for (int n = 0; n < DIMU; ++n) {
+            Um[n] = coeA * Um[n] + coeB * r * Phi[n];
+        }
+        StoreU(tm, idx, Um, node);
         return;
     }
     /* solve step for the solution operator */
+    LoadU(to, idx, node, Uo);
+    LoadU(tn, idx, node, Un);
     for (int n = 0; n < DIMU; ++n) {
         Um[n] = coeA * Uo[n] + coeB * (Un[n] + r * Phi[n]);
     }
+    StoreU(tm, idx, Um, node);
     return;
 }
 /* a good practice: end file with a newline */
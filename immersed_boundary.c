@@ -18,6 +18,7 @@
 #include <float.h> /* size of floating point values */
 #include <string.h> /* manipulating strings */
 #include "computational_geometry.h"
+#include "data_exchange.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -30,24 +31,44 @@ typedef enum {
     TYPED = -1, /* domain as key reconstruction state */
     TYPEF = -2, /* face as key reconstruction state */
     TYPEL = -3, /* layer as key reconstruction state */
+    MAPS = 1, /* scanline node mapping */
+    MAPB = 2, /* swept band node mapping */
 } IbmConst;
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void InitializeGeometricField(Space *);
-static void SetDomainField(Space *);
+static void SetDomainField(Space *, const Model *);
+static void ScanPolyhedron(const int, int [restrict][LIMIT], const Partition *const,
+        Node *const, const Polyhedron *);
+static int HitTriangle(const Real [restrict], const Real, const int, const Polyhedron *,
+        Real [restrict][DIMS], Real [restrict]);
+static int SweepPolyhedron(const int, const int, int [restrict][LIMIT], const Partition *const,
+        Node *const, const Polyhedron *);
+static void MarkSurfaceBand(const int, const int, int [restrict][LIMIT], const Partition *const,
+        const Polyhedron *, int [restrict]);
 static void SetInterfacialField(Space *, const Model *);
+static void SetGhostList(Space *, const Model *);
+static int SetStencil(const int, const int, const Model *, const Partition *const,
+        const Node *const, Geometry *const, int [restrict], Real [restrict]);
 static int GetInterState(const int, const int, const int, const int, const int,
         const int, const int [restrict][DIMS], const Node *const, const Partition *const);
-static void ApplyWeighting(const Real [restrict], const Real, Real,
-        Real [restrict], Real [restrict]);
+static int IsStencilNode(const int, const int, const int, const Node *const);
+static Real ComputeWeight(const Real, Real);
+static void ApplyWeighting(const Real [restrict], const Real, Real [restrict], Real [restrict]);
 static Real InverseDistanceWeighting(const int, const int [restrict],
         const Real [restrict], const int, const int, const int, const Partition *const,
         const Node *const, const Model *, Real [restrict]);
-static void ReconstructFlow(const int, const int [restrict], const Real [restrict],
-        const int, const int, const int, const Polyhedron *, const Partition *const,
-        const Node *const, const Model *, const Real [restrict], const Real [restrict],
-        Real [restrict], Real [restrict]);
+static int SearchStencil(const int [restrict], const Real [restrict], const int, const int,
+        const int, const Partition *const, const Node *const, int [restrict], Real [restrict]);
+static Real GatherStencil(const int, const int, const int, const Geometry *const,
+        const Node *const, const Model *, Real [restrict]);
+static void ReconstructFlow(const Polyhedron *, const Real [restrict], const Real [restrict],
+        const Real, Real, Real [restrict], Real [restrict]);
+#ifdef ARTRACFD_CHECK_BAND
+static int *MapByFullSearch(Space *, const Model *);
+static void CheckSweptBand(int *, const Space *);
+#endif
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -64,11 +85,81 @@ static void ReconstructFlow(const int, const int [restrict], const Real [restric
  */
 void ComputeGeometricField(Space *space, const Model *model)
 {
+#ifdef ARTRACFD_CHECK_BAND
+    int *ref = (MAPB == model->nodeMap) ? MapByFullSearch(space, model) : NULL;
+#endif
     InitializeGeometricField(space);
-    SetDomainField(space);
+    SetDomainField(space, model);
+    ExchangeDomainField(space);
     SetInterfacialField(space, model);
+    ExchangeDomainField(space);
+    SetGhostList(space, model);
+#ifdef ARTRACFD_CHECK_BAND
+    CheckSweptBand(ref, space);
+#endif
     return;
 }
+#ifdef ARTRACFD_CHECK_BAND
+/*
+ * Debug cross-check of the swept band node mapping, enabled by the
+ * preprocessor option ARTRACFD_CHECK_BAND.
+ *
+ * The geometric field is first computed from the same previous field with
+ * the closest face node mapping, which searches all the unclassified nodes
+ * in the bounding box. Its did, fid, lid, and gst are kept as the reference,
+ * and the previous field is restored for the swept band node mapping.
+ */
+static int *MapByFullSearch(Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    Node *const node = space->node;
+    const int totN = part->n[X] * part->n[Y] * part->n[Z];
+    Model full = *model;
+    full.nodeMap = 0;
+    int *keep = AssignStorage(4 * totN * sizeof(*keep)); /* previous field */
+    int *ref = AssignStorage(4 * totN * sizeof(*ref)); /* reference field */
+    memcpy(keep, node->did, totN * sizeof(*keep));
+    memcpy(keep + totN, node->fid, totN * sizeof(*keep));
+    memcpy(keep + 2 * totN, node->lid, totN * sizeof(*keep));
+    memcpy(keep + 3 * totN, node->gst, totN * sizeof(*keep));
+    ComputeGeometricField(space, &full);
+    memcpy(ref, node->did, totN * sizeof(*ref));
+    memcpy(ref + totN, node->fid, totN * sizeof(*ref));
+    memcpy(ref + 2 * totN, node->lid, totN * sizeof(*ref));
+    memcpy(ref + 3 * totN, node->gst, totN * sizeof(*ref));
+    memcpy(node->did, keep, totN * sizeof(*keep));
+    memcpy(node->fid, keep + totN, totN * sizeof(*keep));
+    memcpy(node->lid, keep + 2 * totN, totN * sizeof(*keep));
+    memcpy(node->gst, keep + 3 * totN, totN * sizeof(*keep));
+    RetrieveStorage(keep);
+    return ref;
+}
+/*
+ * Compare the swept band node mapping with the reference of the full
+ * search node by node, and stop at the first difference.
+ */
+static void CheckSweptBand(int *ref, const Space *space)
+{
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    const int totN = part->n[X] * part->n[Y] * part->n[Z];
+    const int *const field[4] = {node->did, node->fid, node->lid, node->gst};
+    const char *const name[4] = {"did", "fid", "lid", "gst"};
+    if (NULL == ref) {
+        return;
+    }
+    for (int m = 0; m < 4; ++m) {
+        for (int idx = 0; idx < totN; ++idx) {
+            if (ref[m * totN + idx] != field[m][idx]) {
+                ShowError("swept band node mapping differs from full search: %s %d != %d at node %d",
+                        name[m], field[m][idx], ref[m * totN + idx], idx);
+            }
+        }
+    }
+    RetrieveStorage(ref);
+    return;
+}
+#endif
 static void InitializeGeometricField(Space *space)
 {
     const Partition *const part = &(space->part);
@@ -81,10 +172,10 @@ static void InitializeGeometricField(Space *space)
         for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
             for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                gid = node[idx].did;
-                node[idx].gst = node[idx].did; /* preserve domain field */
+                gid = node->did[idx];
+                node->gst[idx] = node->did[idx]; /* preserve domain field */
                 if (0 == gid) {
-                    node[idx].fid = 0; /* remove passe domain change mark */
+                    node->fid[idx] = 0; /* remove passe domain change mark */
                     continue; /* skip non-polyhedron nodes */
                 }
                 /* the rest is to treat polyhedron nodes */
@@ -103,8 +194,8 @@ static void InitializeGeometricField(Space *space)
                  * update the closest face id information for the future gl-1
                  * layers, can only reset gl interfacial layers.
                  */
-                if (0 < node[idx].lid) {
-                    node[idx].did = 0;
+                if (0 < node->lid[idx]) {
+                    node->did[idx] = 0;
                 }
             }
         }
@@ -124,8 +215,13 @@ static void InitializeGeometricField(Space *space)
  * is required to ensure minimal test in addition to the bounding container
  * method. Spatial subdivision is to provide internal resolution for the
  * polyhedron for fast inclusion determination.
+ *
+ * For watertight triangulated polyhedrons, the scanline node mapping
+ * classifies nodes line by line instead, see ScanPolyhedron. For moving
+ * triangulated polyhedrons, the swept band node mapping only classifies
+ * nodes near the surface, see SweepPolyhedron.
  */
-static void SetDomainField(Space *space)
+static void SetDomainField(Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
     Node *const node = space->node;
@@ -135,7 +231,7 @@ static void SetDomainField(Space *space)
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
     const Polyhedron *poly = NULL;
     int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
     int fid = 0; /* store face link */
@@ -149,29 +245,37 @@ static void SetDomainField(Space *space)
         }
         /* determine search range according to bounding box of polyhedron and valid node space */
         for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], no[s]), nMin[s], nMax[s]);
+            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], no[s]), nMin[s], nMax[s]) + 1;
+        }
+        if ((0 < poly->faceN) && (MAPS == model->nodeMap)) {
+            ScanPolyhedron(n + 1, box, part, node, poly);
+            continue;
+        }
+        if ((0 < poly->faceN) && (MAPB == model->nodeMap) &&
+                SweepPolyhedron(n + 1, part->gl + 1, box, part, node, poly)) {
+            continue;
         }
         /* find nodes in geometry, then flag and link to geometry */
         for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
             for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
                 for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if (0 != node[idx].did) { /* already classified */
+                    if (0 != node->did[idx]) { /* already classified */
                         continue;
                     }
-                    p[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    p[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    p[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
+                    p[X] = MapPoint(i, sMin[X], d[X], no[X]);
+                    p[Y] = MapPoint(j, sMin[Y], d[Y], no[Y]);
+                    p[Z] = MapPoint(k, sMin[Z], d[Z], no[Z]);
                     if (0 >= poly->faceN) { /* analytical polyhedron */
                         if (poly->r * poly->r >= Dist2(poly->O, p)) {
-                            node[idx].did = n + 1;
-                            node[idx].fid = 0;
+                            node->did[idx] = n + 1;
+                            node->fid[idx] = 0;
                         }
                     } else { /* triangulated polyhedron */
                         if (PointInPolyhedron(p, poly, &fid)) {
-                            node[idx].did = n + 1;
-                            node[idx].fid = fid;
+                            node->did[idx] = n + 1;
+                            node->fid[idx] = fid;
                         }
                     }
                 }
@@ -180,14 +284,300 @@ static void SetDomainField(Space *space)
     }
     return;
 }
+/*
+ * Scanline node mapping of a triangulated polyhedron.
+ *
+ * Faces are first bucketed to the x-direction grid lines that their
+ * projections on the y-z plane may cover. For each grid line, the
+ * crossings of its faces mark the nodes next to the surface, which are
+ * classified by PointInPolyhedron as usual. Between two such zones, the
+ * line does not cross the surface, so the whole run of nodes shares the
+ * state of its first node, and the closest face is left unknown (NONE)
+ * until the node turns out to be an interfacial node.
+ *
+ * Crossings are detected with a small tolerance, so a line through an
+ * edge or a vertex may report redundant crossings but never misses one.
+ * Nodes near the surface are therefore classified exactly as the closest
+ * face method does, and the polyhedron is required to be watertight only
+ * for the runs. The faces of a moving polyhedron are scanned with its
+ * vertices transformed to the world frame.
+ */
+static void ScanPolyhedron(const int gid, int box[restrict][LIMIT], const Partition *const part,
+        Node *const node, const Polyhedron *poly)
+{
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
+    const int nI = box[X][MAX] - box[X][MIN];
+    const int nJ = box[Y][MAX] - box[Y][MIN];
+    const int nK = box[Z][MAX] - box[Z][MIN];
+    const Real tol = 1.0e-6 * MinReal(d[Y], d[Z]); /* crossing detection tolerance */
+    int fid = 0; /* store face link */
+    int idx = 0; /* linear array index math variable */
+    int state = NONE; /* state of current run of nodes */
+    int lim[DIMS][LIMIT] = {{0}}; /* grid lines covered by a face */
+    Real xs[LIMIT] = {0.0}; /* crossing range on a grid line */
+    RealVec p = {0.0}; /* node point */
+    if ((0 >= nI) || (0 >= nJ) || (0 >= nK)) {
+        return;
+    }
+    Real (*v)[DIMS] = poly->v; /* vertices in world frame */
+    if (1 != poly->state) {
+        v = AssignStorage(poly->vertN * sizeof(*v));
+        for (int n = 0; n < poly->vertN; ++n) {
+            TransformToWorld(poly, poly->v[n], v[n]);
+        }
+    }
+    /* bucket faces to grid lines, faces of line l occupy [head[l], head[l+1]) */
+    int *head = AssignStorage((nJ * nK + 1) * sizeof(*head));
+    int *list = NULL;
+    int *near = AssignStorage(nI * sizeof(*near)); /* nodes next to a crossing */
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int n = 0; n < poly->faceN; ++n) {
+            for (int s = Y; s < DIMS; ++s) {
+                xs[MIN] = MinReal(v[poly->f[n][0]][s], MinReal(v[poly->f[n][1]][s], v[poly->f[n][2]][s]));
+                xs[MAX] = MaxReal(v[poly->f[n][0]][s], MaxReal(v[poly->f[n][1]][s], v[poly->f[n][2]][s]));
+                lim[s][MIN] = MaxInt(box[s][MIN], (int)ceil((xs[MIN] - tol - sMin[s]) * dd[s]) + no[s]);
+                lim[s][MAX] = MinInt(box[s][MAX], (int)floor((xs[MAX] + tol - sMin[s]) * dd[s]) + no[s] + 1);
+            }
+            for (int k = lim[Z][MIN]; k < lim[Z][MAX]; ++k) {
+                for (int j = lim[Y][MIN]; j < lim[Y][MAX]; ++j) {
+                    idx = (k - box[Z][MIN]) * nJ + (j - box[Y][MIN]);
+                    if (0 == pass) {
+                        ++head[idx+1];
+                    } else {
+                        list[head[idx]] = n;
+                        ++head[idx];
+                    }
+                }
+            }
+        }
+        if (0 == pass) {
+            for (int l = 0; l < nJ * nK; ++l) {
+                head[l+1] = head[l+1] + head[l];
+            }
+            list = AssignStorage((head[nJ*nK] + 1) * sizeof(*list));
+        } else {
+            for (int l = nJ * nK; l > 0; --l) { /* restore line pointers shifted by filling */
+                head[l] = head[l-1];
+            }
+            head[0] = 0;
+        }
+    }
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            p[Y] = MapPoint(j, sMin[Y], d[Y], no[Y]);
+            p[Z] = MapPoint(k, sMin[Z], d[Z], no[Z]);
+            memset(near, 0, nI * sizeof(*near));
+            idx = (k - box[Z][MIN]) * nJ + (j - box[Y][MIN]);
+            for (int t = head[idx]; t < head[idx+1]; ++t) {
+                if (!HitTriangle(p, tol, list[t], poly, v, xs)) {
+                    continue;
+                }
+                /* nodes bracketing the crossing range, with a safety node on each side */
+                lim[X][MIN] = MaxInt(box[X][MIN], (int)floor((xs[MIN] - sMin[X]) * dd[X]) + no[X] - 1);
+                lim[X][MAX] = MinInt(box[X][MAX], (int)ceil((xs[MAX] - sMin[X]) * dd[X]) + no[X] + 2);
+                for (int i = lim[X][MIN]; i < lim[X][MAX]; ++i) {
+                    near[i-box[X][MIN]] = 1;
+                }
+            }
+            state = NONE;
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                p[X] = MapPoint(i, sMin[X], d[X], no[X]);
+                if (1 == near[i-box[X][MIN]]) {
+                    state = NONE; /* a new run begins after the surface */
+                    if ((0 == node->did[idx]) && PointInPolyhedron(p, poly, &fid)) {
+                        node->did[idx] = gid;
+                        node->fid[idx] = fid;
+                    }
+                    continue;
+                }
+                if (NONE == state) {
+                    state = PointInPolyhedron(p, poly, &fid);
+                }
+                if ((0 == node->did[idx]) && (1 == state)) {
+                    node->did[idx] = gid;
+                    node->fid[idx] = NONE;
+                }
+            }
+        }
+    }
+    RetrieveStorage(head);
+    RetrieveStorage(list);
+    RetrieveStorage(near);
+    if (1 != poly->state) {
+        RetrieveStorage(v);
+    }
+    return;
+}
+/*
+ * Swept band node mapping of a moving triangulated polyhedron.
+ *
+ * After InitializeGeometricField, a node keeps its previous domain in gst,
+ * non-interfacial nodes of a moving polyhedron keep their domain, and its
+ * interfacial nodes are reset. Since a polyhedron moves less than one cell
+ * per step, an unclassified node can only fall into the polyhedron if it
+ * is a reset node or if it lies near the new surface. Therefore, only
+ * nodes within r cells of the new surface, which are marked by the
+ * bounding volume hierarchy, and the reset nodes, which are within gl
+ * layers of the old surface, are classified by PointInPolyhedron. Others
+ * keep their domain, which gives the same domain field as a full search.
+ *
+ * A polyhedron without any previously mapped node in the search range,
+ * e.g., at the first mapping, needs a full search and returns 0.
+ */
+static int SweepPolyhedron(const int gid, const int r, int box[restrict][LIMIT],
+        const Partition *const part, Node *const node, const Polyhedron *poly)
+{
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
+    const int nI = box[X][MAX] - box[X][MIN];
+    const int nJ = box[Y][MAX] - box[Y][MIN];
+    const int nK = box[Z][MAX] - box[Z][MIN];
+    int fid = 0; /* store face link */
+    int idx = 0; /* linear array index math variable */
+    int flag = 0; /* control flag */
+    RealVec p = {0.0}; /* node point */
+    if ((0 >= nI) || (0 >= nJ) || (0 >= nK)) {
+        return 1;
+    }
+    /* search previously mapped nodes */
+    for (int k = box[Z][MIN]; (k < box[Z][MAX]) && (0 == flag); ++k) {
+        for (int j = box[Y][MIN]; (j < box[Y][MAX]) && (0 == flag); ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (gid == node->gst[idx]) {
+                    flag = 1;
+                    break;
+                }
+            }
+        }
+    }
+    if (0 == flag) {
+        return 0;
+    }
+    int *band = AssignStorage(nI * nJ * nK * sizeof(*band)); /* nodes near the new surface */
+    MarkSurfaceBand(0, r, box, part, poly, band);
+    for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+        for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != node->did[idx]) { /* already classified */
+                    continue;
+                }
+                if ((0 == node->gst[idx]) &&
+                        (0 == band[((k - box[Z][MIN]) * nJ + (j - box[Y][MIN])) * nI + (i - box[X][MIN])])) {
+                    continue; /* neither reset nor near the new surface */
+                }
+                p[X] = MapPoint(i, sMin[X], d[X], no[X]);
+                p[Y] = MapPoint(j, sMin[Y], d[Y], no[Y]);
+                p[Z] = MapPoint(k, sMin[Z], d[Z], no[Z]);
+                if (PointInPolyhedron(p, poly, &fid)) {
+                    node->did[idx] = gid;
+                    node->fid[idx] = fid;
+                }
+            }
+        }
+    }
+    RetrieveStorage(band);
+    return 1;
+}
+/*
+ * Mark nodes within r cells of the bounding volume hierarchy node m. The
+ * hierarchy is descended until node boxes span no more than two cells, so
+ * the marked band follows the surface instead of the whole bounding box.
+ */
+static void MarkSurfaceBand(const int m, const int r, int box[restrict][LIMIT],
+        const Partition *const part, const Polyhedron *poly, int band[restrict])
+{
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
+    const int nI = box[X][MAX] - box[X][MIN];
+    const int nJ = box[Y][MAX] - box[Y][MIN];
+    Bvh *const bvh = poly->bvh + m;
+    Real bw[DIMS][LIMIT] = {{0.0}}; /* node box in world frame */
+    int lim[DIMS][LIMIT] = {{0}}; /* node range of the band */
+    int split = 0; /* whether to descend further */
+    TransformBox(poly, bvh->box, bw);
+    for (int s = 0; s < DIMS; ++s) {
+        lim[s][MIN] = MaxInt(box[s][MIN], MapNode(bw[s][MIN] - r * d[s], sMin[s], dd[s], no[s]));
+        lim[s][MAX] = MinInt(box[s][MAX], MapNode(bw[s][MAX] + r * d[s], sMin[s], dd[s], no[s]) + 1);
+        if (lim[s][MIN] >= lim[s][MAX]) {
+            return; /* out of search range */
+        }
+        if (bw[s][MAX] - bw[s][MIN] > 2.0 * d[s]) {
+            split = 1;
+        }
+    }
+    if ((0 != bvh->child) && (1 == split)) {
+        MarkSurfaceBand(bvh->child, r, box, part, poly, band);
+        MarkSurfaceBand(bvh->child + 1, r, box, part, poly, band);
+        return;
+    }
+    for (int k = lim[Z][MIN]; k < lim[Z][MAX]; ++k) {
+        for (int j = lim[Y][MIN]; j < lim[Y][MAX]; ++j) {
+            for (int i = lim[X][MIN]; i < lim[X][MAX]; ++i) {
+                band[((k - box[Z][MIN]) * nJ + (j - box[Y][MIN])) * nI + (i - box[X][MIN])] = 1;
+            }
+        }
+    }
+    return;
+}
+/*
+ * Check whether the x-direction line through point p crosses face fid,
+ * with the line widened by tol, and find the crossing range xs on the line.
+ */
+static int HitTriangle(const Real p[restrict], const Real tol, const int fid, const Polyhedron *poly,
+        Real vert[restrict][DIMS], Real xs[restrict])
+{
+    const Real *v[POLYN] = {vert[poly->f[fid][0]], vert[poly->f[fid][1]], vert[poly->f[fid][2]]};
+    Real len[POLYN] = {0.0}; /* length of projected edges */
+    Real dist[POLYN] = {0.0}; /* signed distance to projected edges */
+    Real area = 0.0; /* twice the signed projected area */
+    for (int n = 0; n < POLYN; ++n) {
+        const Real *v0 = v[n];
+        const Real *v1 = v[(n + 1) % POLYN];
+        len[n] = sqrt((v1[Y] - v0[Y]) * (v1[Y] - v0[Y]) + (v1[Z] - v0[Z]) * (v1[Z] - v0[Z]));
+        dist[n] = (v1[Y] - v0[Y]) * (p[Z] - v0[Z]) - (v1[Z] - v0[Z]) * (p[Y] - v0[Y]);
+    }
+    area = (v[1][Y] - v[0][Y]) * (v[2][Z] - v[0][Z]) - (v[1][Z] - v[0][Z]) * (v[2][Y] - v[0][Y]);
+    xs[MIN] = MinReal(v[0][X], MinReal(v[1][X], v[2][X]));
+    xs[MAX] = MaxReal(v[0][X], MaxReal(v[1][X], v[2][X]));
+    if (fabs(area) <= tol * (len[0] + len[1] + len[2])) {
+        /* face parallel to the line: the bucket already ensures closeness, keep the whole range */
+        return 1;
+    }
+    for (int n = 0; n < POLYN; ++n) {
+        if (((0.0 < area) ? dist[n] : -dist[n]) < -tol * len[n]) {
+            return 0;
+        }
+    }
+    /* x = v0 - (Ny * (y - y0) + Nz * (z - z0)) / Nx on the face plane, and Nx = area */
+    const RealVec e01 = {v[1][X] - v[0][X], v[1][Y] - v[0][Y], v[1][Z] - v[0][Z]};
+    const RealVec e02 = {v[2][X] - v[0][X], v[2][Y] - v[0][Y], v[2][Z] - v[0][Z]};
+    const Real Ny = e01[Z] * e02[X] - e01[X] * e02[Z];
+    const Real Nz = e01[X] * e02[Y] - e01[Y] * e02[X];
+    const Real x = v[0][X] - (Ny * (p[Y] - v[0][Y]) + Nz * (p[Z] - v[0][Z])) / area;
+    xs[MIN] = MaxReal(xs[MIN], MinReal(xs[MAX], x));
+    xs[MAX] = xs[MIN];
+    return 1;
+}
 static void SetInterfacialField(Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
     Node *const node = space->node;
+    const Geometry *const geo = &(space->geo);
     int idx = 0; /* linear array index math variable */
+    int fid = 0; /* store face link */
     const int sd = 0; /* solution domain */
     IntVec n = {0}; /* current node */
     RealVec p = {0.0}; /* node point */
+    Real U[DIMU] = {0.0};
     Real Uo[DIMUo] = {0.0};
     Real weightSum = 0.0;
     for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
@@ -195,34 +585,156 @@ static void SetInterfacialField(Space *space, const Model *model)
             for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
                 /* reconstruct newly joined node for the solution domain */
-                if ((node[idx].gst != node[idx].did) && (sd == node[idx].did)) {
+                if ((node->gst[idx] != node->did[idx]) && (sd == node->did[idx])) {
                     /* a newly joined solution domain node */
                     n[X] = i; n[Y] = j; n[Z] = k;
-                    p[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
-                    p[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
-                    p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
-                    weightSum = InverseDistanceWeighting(TO, n, p, R, TYPEF, node[idx].did, part, node, model, Uo);
+                    p[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->no[X]);
+                    p[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->no[Y]);
+                    p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->no[Z]);
+                    weightSum = InverseDistanceWeighting(TO, n, p, R, TYPEF, node->did[idx], part, node, model, Uo);
                     Normalize(DIMUo, weightSum, Uo);
                     Uo[0] = Uo[4] / (Uo[5] * model->gasR); /* compute density */
-                    MapConservative(model->gamma, Uo, node[idx].U[TO]);
-                    node[idx].fid = NONE; /* set domain change mark to avoid reconstruction interference */
+                    MapConservative(model->gamma, Uo, U);
+                    StoreU(TO, idx, U, node);
+                    node->fid[idx] = NONE; /* set domain change mark to avoid reconstruction interference */
                 }
                 /* reset interfacial state */
-                node[idx].lid = 0;
-                node[idx].gst = 0;
+                node->lid[idx] = 0;
+                node->gst[idx] = 0;
                 /* search neighbours to determine the current interfacial state */
-                if (sd == node[idx].did) { /* skip interfacial nodes for main domain */
+                if (sd == node->did[idx]) { /* skip interfacial nodes for main domain */
                     continue;
                 }
-                node[idx].lid = GetInterState(INTERL, k, j, i, node[idx].did, part->pathSep[0], part->path, node, part);
-                if ((0 < node[idx].lid) && (sd != node[idx].did)) { /* ghost node is a subset of interfacial node */
-                    node[idx].gst = GetInterState(INTERG, k, j, i, sd, part->pathSep[0], part->path, node, part);
+                node->lid[idx] = GetInterState(INTERL, k, j, i, node->did[idx], part->pathSep[0], part->path, node, part);
+                if ((0 < node->lid[idx]) && (sd != node->did[idx])) { /* ghost node is a subset of interfacial node */
+                    node->gst[idx] = GetInterState(INTERG, k, j, i, sd, part->pathSep[0], part->path, node, part);
+                }
+                if ((0 < node->lid[idx]) && (0 > node->fid[idx])) { /* closest face left by scanline mapping */
+                    p[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->no[X]);
+                    p[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->no[Y]);
+                    p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->no[Z]);
+                    PointInPolyhedron(p, geo->poly + node->did[idx] - 1, &fid);
+                    node->fid[idx] = fid;
                 }
             }
         }
     }
     return;
 }
+/*
+ * Ghost nodes are collected into a compact list grouped by ghost layer,
+ * with the linked geometry and face of each node. The list stays valid
+ * until the geometric field is recomputed, so the immersed boundary
+ * treatment of every stage visits ghost nodes only.
+ *
+ * The interpolation stencil of each ghost node, that is, its stencil nodes
+ * and inverse distance weights together with the boundary point and normal,
+ * depends only on the geometric field as well. It is cached in a sparse
+ * stencil table here, which reduces the treatment of each stage to a
+ * weighted gather plus the method of image. The table is built once
+ * without phase interaction. Otherwise the geometric field is recomputed
+ * every step, and the whole table is rebuilt with it, including the
+ * entries of stationary geometries: a moving geometry may take or release
+ * stencil nodes of a stationary one, and the ghost list is renumbered.
+ */
+static void SetGhostList(Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    Geometry *const geo = &(space->geo);
+    int idx = 0; /* linear array index math variable */
+    int count[PATHSEP] = {0}; /* ghost node count and list pointer of each layer */
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if ((0 != node->did[idx]) && (0 < node->gst[idx])) {
+                    ++count[node->gst[idx]];
+                }
+            }
+        }
+    }
+    /* layer r occupies [ghostN[r-1], ghostN[r]) */
+    geo->ghostN[0] = 0;
+    for (int r = 1; r <= part->gl; ++r) {
+        geo->ghostN[r] = geo->ghostN[r-1] + count[r];
+        count[r] = geo->ghostN[r-1];
+    }
+    const int totN = geo->ghostN[part->gl];
+    RetrieveStorage(geo->ghost);
+    RetrieveStorage(geo->ghostO);
+    geo->ghost = AssignStorage((totN + 1) * sizeof(*geo->ghost));
+    geo->ghostO = AssignStorage((totN + 1) * sizeof(*geo->ghostO));
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if ((0 != node->did[idx]) && (0 < node->gst[idx])) {
+                    geo->ghost[count[node->gst[idx]]][0] = idx;
+                    geo->ghost[count[node->gst[idx]]][1] = node->did[idx] - 1;
+                    geo->ghost[count[node->gst[idx]]][2] = node->fid[idx];
+                    ++count[node->gst[idx]];
+                }
+            }
+        }
+    }
+    /* size the stencil table, then fill it; stencils of entry m occupy [ghost[m][3], ghost[m+1][3]) */
+    int stenN = 0;
+    for (int r = 1; r <= part->gl; ++r) {
+        for (int m = geo->ghostN[r-1]; m < geo->ghostN[r]; ++m) {
+            geo->ghost[m][3] = stenN;
+            stenN = stenN + SetStencil(r, m, model, part, node, geo, NULL, NULL);
+        }
+    }
+    geo->ghost[totN][3] = stenN;
+    RetrieveStorage(geo->sten);
+    RetrieveStorage(geo->stenW);
+    geo->sten = AssignStorage((stenN + 1) * sizeof(*geo->sten));
+    geo->stenW = AssignStorage((stenN + 1) * sizeof(*geo->stenW));
+    for (int r = 1; r <= part->gl; ++r) {
+        for (int m = geo->ghostN[r-1]; m < geo->ghostN[r]; ++m) {
+            SetStencil(r, m, model, part, node, geo, geo->sten + geo->ghost[m][3], geo->stenW + geo->ghost[m][3]);
+        }
+    }
+    return;
+}
+/*
+ * Determine the interpolation stencil of the ghost node entry m in layer r,
+ * and return the number of stencil nodes. Stencil nodes and weights are
+ * only counted when the output lists are NULL.
+ */
+static int SetStencil(const int r, const int m, const Model *model, const Partition *const part,
+        const Node *const node, Geometry *const geo, int stencil[restrict], Real weight[restrict])
+{
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
+    const int idx = geo->ghost[m][0];
+    const int n = geo->ghost[m][1];
+    Real *const pO = geo->ghostO[m]; /* boundary point */
+    Real *const N = geo->ghostO[m] + DIMS; /* normal */
+    IntVec nI = {0}; /* image node */
+    IntVec nG = {0}; /* ghost node */
+    RealVec pG = {0.0}; /* ghost point */
+    RealVec pI = {0.0}; /* image point */
+    nG[X] = idx % part->n[X];
+    nG[Y] = (idx / part->n[X]) % part->n[Y];
+    nG[Z] = idx / (part->n[X] * part->n[Y]);
+    pG[X] = MapPoint(nG[X], sMin[X], d[X], no[X]);
+    pG[Y] = MapPoint(nG[Y], sMin[Y], d[Y], no[Y]);
+    pG[Z] = MapPoint(nG[Z], sMin[Z], d[Z], no[Z]);
+    if (model->ibmLayer >= r) { /* immersed boundary treatment */
+        ComputeGeometricData(pG, geo->ghost[m][2], geo->poly + n, pO, pI, N);
+        nI[X] = MapNode(pI[X], sMin[X], dd[X], no[X]);
+        nI[Y] = MapNode(pI[Y], sMin[Y], dd[Y], no[Y]);
+        nI[Z] = MapNode(pI[Z], sMin[Z], dd[Z], no[Z]);
+        geo->ghostO[m][GSTO-1] = ComputeWeight(part->tinyL, Dist2(pI, pO));
+        return SearchStencil(nI, pI, R, TYPED, 0, part, node, stencil, weight);
+    }
+    /* inverse distance weighting */
+    return SearchStencil(nG, pG, 1, r - 1, n + 1, part, node, stencil, weight);
+}
 static int GetInterState(const int sid, const int k, const int j, const int i, const int did,
         const int end, const int path[restrict][DIMS], const Node *const node, const Partition *const part)
 {
@@ -234,18 +746,18 @@ static int GetInterState(const int sid, const int k, const int j, const int i, c
         kh = k + path[n][Z];
         jh = j + path[n][Y];
         ih = i + path[n][X];
-        if (!InPartBox(kh, jh, ih, part->ns[PIN])) {
+        if (!InPartBox(kh, jh, ih, part->ns[PEX])) {
             continue;
         }
         idx = IndexNode(kh, jh, ih, part->n[Y], part->n[X]);
         switch (sid) {
             case INTERL:
-                if (did != node[idx].did) { /* a heterogeneous node on the path */
+                if (did != node->did[idx]) { /* a heterogeneous node on the path */
                     flag = 1;
                 }
                 break;
             case INTERG:
-                if (did == node[idx].did) { /* a computational node on the path */
+                if (did == node->did[idx]) { /* a computational node on the path */
                     flag = 1;
                 }
                 break;
@@ -272,68 +784,48 @@ void TreatImmersedBoundary(const int tn, Space *space, const Model *model)
     const Partition *const part = &(space->part);
     Node *const node = space->node;
     const Geometry *const geo = &(space->geo);
-    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
-    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
-    const Polyhedron *poly = NULL;
     int idx = 0; /* linear array index math variable */
-    IntVec nI = {0}; /* image node */
-    IntVec nG = {0}; /* ghost node */
-    RealVec pG = {0.0}; /* ghost point */
-    RealVec pO = {0.0}; /* boundary point */
-    RealVec pI = {0.0}; /* image point */
-    RealVec N = {0.0}; /* normal */
+    Real U[DIMU] = {0.0};
     Real UoG[DIMUo] = {0.0};
     Real UoO[DIMUo] = {0.0};
     Real UoI[DIMUo] = {0.0};
     Real weightSum = 0.0;
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
-    for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
-        /* treat ghost nodes */
-        for (int r = 1; r <= part->gl; ++r) { /* layer by layer treatment */
-            for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-                for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                    for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        if ((r != node[idx].gst) || (n + 1 != node[idx].did)) {
-                            continue;
-                        }
-                        pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                        pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                        pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                        if (model->ibmLayer >= r) { /* immersed boundary treatment */
-                            ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                            nI[X] = MapNode(pI[X], sMin[X], dd[X], ng[X]);
-                            nI[Y] = MapNode(pI[Y], sMin[Y], dd[Y], ng[Y]);
-                            nI[Z] = MapNode(pI[Z], sMin[Z], dd[Z], ng[Z]);
-                            /*
-                             * When extremely strong discontinuities exist in the
-                             * domain of dependence of inverse distance weighting,
-                             * WENO's idea may be adopted to avoid discontinuous
-                             * stencils and to only use smooth stencils. However,
-                             * the algorithm will be too complex.
-                             */
-                            ReconstructFlow(tn, nI, pI, R, TYPED, 0, poly, part, node, model, pO, N, UoO, UoI);
-                            DoMethodOfImage(UoI, UoO, UoG);
-                        } else { /* inverse distance weighting */
-                            nG[X] = i; nG[Y] = j; nG[Z] = k;
-                            weightSum = InverseDistanceWeighting(tn, nG, pG, 1, r - 1, n + 1, part, node, model, UoG);
-                            Normalize(DIMUo, weightSum, UoG);
-                        }
-                        UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
-                        MapConservative(model->gamma, UoG, node[idx].U[tn]);
-                    }
-                }
+    if (0 == geo->totN) {
+        return;
+    }
+    /* reconstruction stencils may extend to neighbouring blocks */
+    ExchangeFieldData(tn, space);
+    /*
+     * Treat ghost nodes layer by layer. Ghost nodes are independent in each
+     * layer, which permits the layer loop to enclose the ghost node loop,
+     * so that layers interpolated from the previous layer can receive it
+     * from neighbouring blocks.
+     */
+    for (int r = 1; r <= part->gl; ++r) {
+        for (int m = geo->ghostN[r-1]; m < geo->ghostN[r]; ++m) {
+            idx = geo->ghost[m][0];
+            if (model->ibmLayer >= r) { /* immersed boundary treatment */
+                /*
+                 * When extremely strong discontinuities exist in the
+                 * domain of dependence of inverse distance weighting,
+                 * WENO's idea may be adopted to avoid discontinuous
+                 * stencils and to only use smooth stencils. However,
+                 * the algorithm will be too complex.
+                 */
+                weightSum = GatherStencil(tn, geo->ghost[m][3], geo->ghost[m+1][3], geo, node, model, UoI);
+                ReconstructFlow(geo->poly + geo->ghost[m][1], geo->ghostO[m], geo->ghostO[m] + DIMS,
+                        geo->ghostO[m][GSTO-1], weightSum, UoO, UoI);
+                DoMethodOfImage(UoI, UoO, UoG);
+            } else { /* inverse distance weighting */
+                weightSum = GatherStencil(tn, geo->ghost[m][3], geo->ghost[m+1][3], geo, node, model, UoG);
+                Normalize(DIMUo, weightSum, UoG);
             }
+            UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
+            MapConservative(model->gamma, UoG, U);
+            StoreU(tn, idx, U, node);
+        }
+        if ((part->gl > r) && (model->ibmLayer < r + 1)) { /* next layer interpolates this layer */
+            ExchangeFieldData(tn, space);
         }
     }
     return;
@@ -354,15 +846,17 @@ void DoMethodOfImage(const Real UoI[restrict], const Real UoO[restrict], Real Uo
     UoG[5] = UoI[5];
     return;
 }
-static void ReconstructFlow(const int tn, const int n[restrict], const Real p[restrict],
-        const int h, const int type, const int did, const Polyhedron *poly, const Partition *const part,
-        const Node *const node, const Model *model, const Real pO[restrict], const Real N[restrict],
-        Real UoO[restrict], Real Uo[restrict])
+/*
+ * Enforce the boundary condition at the boundary point pO from the
+ * pre-estimated weighted sum Uo, then correct Uo by adding the boundary
+ * point with weight weightO as a stencil.
+ */
+static void ReconstructFlow(const Polyhedron *poly, const Real pO[restrict], const Real N[restrict],
+        const Real weightO, Real weightSum, Real UoO[restrict], Real Uo[restrict])
 {
     const Real zero = 0.0;
     const Real one = 1.0;
     /* pre-estimate step */
-    Real weightSum = InverseDistanceWeighting(tn, n, p, h, type, did, part, node, model, Uo);
     const Real weight = one / weightSum;
     /* physical boundary condition enforcement step */
     RealVec Vs = {zero}; /* general motion of boundary point */
@@ -405,7 +899,7 @@ static void ReconstructFlow(const int tn, const int n[restrict], const Real p[re
         UoO[5] = poly->T;
     }
     /* correction step by adding the boundary point as a stencil */
-    ApplyWeighting(UoO, part->tinyL, Dist2(p, pO), &weightSum, Uo);
+    ApplyWeighting(UoO, weightO, &weightSum, Uo);
     /* Normalize the weighted values */
     Normalize(DIMUo, weightSum, Uo);
     return;
@@ -417,7 +911,8 @@ static Real InverseDistanceWeighting(const int tn, const int n[restrict], const
     int idx = 0; /* linear array index math variable */
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
+    Real U[DIMU] = {0.0}; /* conservative at neighbouring node */
     Real Uoh[DIMUo] = {0.0}; /* primitive at neighbouring node */
     RealVec ph = {0.0}; /* neighbouring point */
     IntVec nh = {0}; /* neighbouring node */
@@ -437,48 +932,116 @@ static Real InverseDistanceWeighting(const int tn, const int n[restrict], const
                     nh[X] = n[X] + ih;
                     nh[Y] = n[Y] + jh;
                     nh[Z] = n[Z] + kh;
-                    if (!InPartBox(nh[Z], nh[Y], nh[X], part->ns[PIN])) {
+                    if (!InPartBox(nh[Z], nh[Y], nh[X], part->ns[PEX])) {
                         continue;
                     }
                     idx = IndexNode(nh[Z], nh[Y], nh[X], part->n[Y], part->n[X]);
-                    /* be aware of the validity of ih = jh = kh = 0 */
-                    if (did != node[idx].did) {
-                        continue; /* skip node not in target domain */
+                    if (!IsStencilNode(idx, type, did, node)) {
+                        continue;
                     }
-                    switch (type) {
-                        case TYPED: /* use node in target domain */
-                            break;
-                        case TYPEF: /* use original node in target domain to avoid priority */
-                            if ((did != node[idx].gst) || (0 > node[idx].fid)) {
-                                continue; /* skip changed node either reconstructed or not */
-                            }
-                            break;
-                        default: /* use node in target domain layer */
-                            if (type != node[idx].gst) {
-                                continue;
-                            }
-                            break;
+                    ++tally;
+                    ph[X] = MapPoint(nh[X], sMin[X], d[X], no[X]);
+                    ph[Y] = MapPoint(nh[Y], sMin[Y], d[Y], no[Y]);
+                    ph[Z] = MapPoint(nh[Z], sMin[Z], d[Z], no[Z]);
+                    LoadU(tn, idx, node, U);
+                    MapPrimitive(model->gamma, model->gasR, U, Uoh);
+                    ApplyWeighting(Uoh, ComputeWeight(part->tinyL, Dist2(p, ph)), &weightSum, Uo);
+                }
+            }
+        }
+    }
+    return weightSum;
+}
+/*
+ * Search stencil nodes in the same way as inverse distance weighting, but
+ * record node indices and weights instead of accumulating the flow field.
+ * Nothing is recorded when the output lists are NULL.
+ */
+static int SearchStencil(const int n[restrict], const Real p[restrict], const int h, const int type,
+        const int did, const Partition *const part, const Node *const node,
+        int stencil[restrict], Real weight[restrict])
+{
+    int idx = 0; /* linear array index math variable */
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
+    RealVec ph = {0.0}; /* neighbouring point */
+    IntVec nh = {0}; /* neighbouring node */
+    int tally = 0;
+    for (int r = h; 0 == tally; ++r) {
+        for (int kh = -r; kh <= r; ++kh) {
+            for (int jh = -r; jh <= r; ++jh) {
+                for (int ih = -r; ih <= r; ++ih) {
+                    nh[X] = n[X] + ih;
+                    nh[Y] = n[Y] + jh;
+                    nh[Z] = n[Z] + kh;
+                    if (!InPartBox(nh[Z], nh[Y], nh[X], part->ns[PEX])) {
+                        continue;
+                    }
+                    idx = IndexNode(nh[Z], nh[Y], nh[X], part->n[Y], part->n[X]);
+                    if (!IsStencilNode(idx, type, did, node)) {
+                        continue;
+                    }
+                    if (NULL != stencil) {
+                        ph[X] = MapPoint(nh[X], sMin[X], d[X], no[X]);
+                        ph[Y] = MapPoint(nh[Y], sMin[Y], d[Y], no[Y]);
+                        ph[Z] = MapPoint(nh[Z], sMin[Z], d[Z], no[Z]);
+                        stencil[tally] = idx;
+                        weight[tally] = ComputeWeight(part->tinyL, Dist2(p, ph));
                     }
                     ++tally;
-                    ph[X] = MapPoint(nh[X], sMin[X], d[X], ng[X]);
-                    ph[Y] = MapPoint(nh[Y], sMin[Y], d[Y], ng[Y]);
-                    ph[Z] = MapPoint(nh[Z], sMin[Z], d[Z], ng[Z]);
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[tn], Uoh);
-                    ApplyWeighting(Uoh, part->tinyL, Dist2(p, ph), &weightSum, Uo);
                 }
             }
         }
     }
+    return tally;
+}
+static int IsStencilNode(const int idx, const int type, const int did, const Node *const node)
+{
+    /* be aware of the validity of ih = jh = kh = 0 */
+    if (did != node->did[idx]) {
+        return 0; /* skip node not in target domain */
+    }
+    switch (type) {
+        case TYPED: /* use node in target domain */
+            return 1;
+        case TYPEF: /* use original node in target domain to avoid priority */
+            if ((did != node->gst[idx]) || (0 > node->fid[idx])) {
+                return 0; /* skip changed node either reconstructed or not */
+            }
+            return 1;
+        default: /* use node in target domain layer */
+            if (type != node->gst[idx]) {
+                return 0;
+            }
+            return 1;
+    }
+}
+static Real GatherStencil(const int tn, const int start, const int end, const Geometry *const geo,
+        const Node *const node, const Model *model, Real Uo[restrict])
+{
+    Real U[DIMU] = {0.0}; /* conservative at stencil node */
+    Real Uoh[DIMUo] = {0.0}; /* primitive at stencil node */
+    Real weightSum = 0.0;
+    memset(Uo, 0, DIMUo * sizeof(*Uo));
+    for (int t = start; t < end; ++t) {
+        LoadU(tn, geo->sten[t], node, U);
+        MapPrimitive(model->gamma, model->gasR, U, Uoh);
+        ApplyWeighting(Uoh, geo->stenW[t], &weightSum, Uo);
+    }
     return weightSum;
 }
-static void ApplyWeighting(const Real Uoh[restrict], const Real tiny, Real weight,
-        Real weightSum[restrict], Real Uo[restrict])
+static Real ComputeWeight(const Real tiny, Real weight)
 {
     const Real one = 1.0;
     if (tiny > weight) { /* avoid overflow of too small weight */
         weight = tiny;
     }
-    weight = one / weight; /* compute weight */
+    return one / weight;
+}
+static void ApplyWeighting(const Real Uoh[restrict], const Real weight,
+        Real weightSum[restrict], Real Uo[restrict])
+{
     for (int n = 0; n < DIMUo; ++n) {
         Uo[n] = Uo[n] + Uoh[n] * weight;
     }
@@ -486,4 +1049,3 @@ static void ApplyWeighting(const Real Uoh[restrict], const Real tiny, Real weigh
     return;
 }
 /* a good practice: end file with a newline */
-
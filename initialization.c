@@ -19,7 +19,10 @@
 #include "immersed_boundary.h"
 #include "boundary_treatment.h"
 #include "data_stream.h"
+#include "checkpoint.h"
+#include "statistics.h"
 #include "stl.h"
+#include "timer.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -31,23 +34,34 @@ static void ApplyInitializer(const int, const Real [restrict],
         Real [restrict], const Partition *const, const Model *);
 static void InitializeGeometryData(Geometry *const);
 static void WritePolyMassProperty(const Geometry *const);
-static void IdentifyGeometryState(Geometry *const);
+static void IdentifyGeometryState(Geometry *const, const Model *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void InitializeComputeDomain(Time *time, Space *space, const Model *model)
 {
+    if ((0 != time->restart) && (0 != time->ckW) && (0 == ReadCheckpoint(time, space))) {
+        return; /* the exact computing state is restored */
+    }
     if (0 == time->restart) { /* non restart */
         InitializeSpaceData(space, model);
     } else {
         ReadData(PROSD, time, space, model);
     }
     ComputeGeometryParameters(space->part.collapse, &(space->geo));
-    WritePolyMassProperty(&(space->geo));
+    if (0 == space->part.rank) {
+        WritePolyMassProperty(&(space->geo));
+    }
+    Timer tm; /* timer for the initial node mapping */
+    TickTime(&tm);
     ComputeGeometricField(space, model);
+    ShowInfo("  mapping nodes elapsed: %.6gs\n", TockTime(&tm));
     TreatBoundary(TO, space, model);
-    IdentifyGeometryState(&(space->geo));
+    IdentifyGeometryState(&(space->geo), model);
     if (0 == time->restart) { /* non restart */
+        if (0 != time->statW) { /* the initial field is the first sample */
+            AccumulateStatistics(time, space, model);
+        }
         WriteData(PROPT, time, space, model);
         WriteData(PROFC, time, space, model);
         WriteData(PROSD, time, space, model);
@@ -70,31 +84,38 @@ static void InitializeFieldData(Space *space, const Model *model)
     const Partition *const part = &(space->part);
     Node *const node = space->node;
     RealVec pc = {0.0}; /* coordinates of current node */
+    Real U[DIMU] = {0.0}; /* conservative variables of current node */
     int idx = 0; /* linear array index math variable */
     for (int k = part->ns[PAL][Z][MIN]; k < part->ns[PAL][Z][MAX]; ++k) {
         for (int j = part->ns[PAL][Y][MIN]; j < part->ns[PAL][Y][MAX]; ++j) {
             for (int i = part->ns[PAL][X][MIN]; i < part->ns[PAL][X][MAX]; ++i) {
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                node[idx].did = NONE;
-                node[idx].fid = NONE;
-                node[idx].lid = NONE;
-                node[idx].gst = NONE;
-                memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
+                node->did[idx] = NONE;
+                node->fid[idx] = NONE;
+                node->lid[idx] = NONE;
+                node->gst[idx] = NONE;
+                for (int t = 0; t < node->levelN; ++t) {
+                    for (int n = 0; n < DIMU; ++n) {
+                        memset(node->U[t][n] + idx, 1, sizeof(Real));
+                    }
+                }
                 if (!InPartBox(k, j, i, part->ns[PIN])) {
                     continue;
                 }
                 /* geometric field initializer */
-                node[idx].did = 0;
-                node[idx].fid = 0;
-                node[idx].lid = 0;
-                node[idx].gst = 0;
+                node->did[idx] = 0;
+                node->fid[idx] = 0;
+                node->lid[idx] = 0;
+                node->gst[idx] = 0;
                 /* data field initializer */
-                pc[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
-                pc[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
-                pc[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
+                pc[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->no[X]);
+                pc[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->no[Y]);
+                pc[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->no[Z]);
+                LoadU(TO, idx, node, U);
                 for (int n = 0; n < part->nIC; ++n) {
-                    ApplyInitializer(n, pc, node[idx].U[TO], part, model);
+                    ApplyInitializer(n, pc, U, part, model);
                 }
+                StoreU(TO, idx, U, node);
             }
         }
     }
@@ -232,12 +253,19 @@ static void WritePolyMassProperty(const Geometry *const geo)
     fclose(fp);
     return;
 }
-static void IdentifyGeometryState(Geometry *const geo)
+/*
+ * Identify the dynamic motion state of polyhedrons. The contact model does
+ * not contact two triangulated polyhedrons, which is rejected if any of
+ * them could move rather than silently letting them pass through.
+ */
+static void IdentifyGeometryState(Geometry *const geo, const Model *model)
 {
     Polyhedron *poly = NULL;
     const Real zero = 0.0;
     const Real rhoNoForce = 1.0e10;
     const Real rhoNoMove = 1.0e36;
+    int triN = 0; /* number of triangulated polyhedrons */
+    int moveN = 0; /* number of moving triangulated polyhedrons */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         if (rhoNoForce < poly->rho) { /* ignore surface force integration */
@@ -251,6 +279,15 @@ static void IdentifyGeometryState(Geometry *const geo)
                 poly->state = 1;
             }
         }
+        if (0 < poly->faceN) {
+            ++triN;
+            if (1 != poly->state) {
+                ++moveN;
+            }
+        }
+    }
+    if ((3 == model->psi) && (1 < triN) && (0 < moveN)) {
+        ShowError("triangulated polyhedrons do not contact each other in DEM, use phase interaction 2");
     }
     return;
 }
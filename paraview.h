@@ -23,13 +23,27 @@
 typedef enum {
     PVSTR = 80, /* string data length */
     PVVARSTR = 10, /* variable name length */
-    PVSCAN = 10, /* maximum number of scalar variables */
+    PVSCAN = 15, /* maximum number of scalar variables */
     PVVECN = 1, /* maximum number of vector variables */
+    PVBUFN = 12288, /* bytes of the data stream buffer, a multiple of 3 and 4 */
 } PvConst;
+typedef enum {
+    PVFIELD = 0, /* field data */
+    PVSTATS = 1, /* field statistics */
+    PVSPH = 2, /* analytical polyhedrons */
+    PVSTL = 3, /* triangulated polyhedrons */
+    PVINDEXN = 4, /* number of transient case file series */
+} PvSeries;
+typedef enum {
+    PVASCII = 0, /* ascii data */
+    PVRAW = 1, /* appended raw binary data */
+    PVBASE64 = 2, /* inline base64 encoded binary data */
+} PvFormat;
 typedef char PvStr[PVSTR]; /* string data */
 typedef Real PvReal; /* real data */
 typedef struct {
     PvStr rname; /* data file root name */
+    int series; /* transient case file series */
     PvStr bname; /* data file base name */
     PvStr fname; /* store current open file name */
     PvStr fext; /* data file extension */
@@ -41,7 +55,22 @@ typedef struct {
     char sca[PVSCAN][PVVARSTR]; /* scalar variables */
     int vecN; /* number of vector variables */
     char vec[PVVECN][PVVARSTR]; /* vector variables */
+    int format; /* data encoding format */
+    const Real *stat; /* running statistics, NULL for the field data */
+    int sampleN; /* number of statistics samples */
 } PvSet; /* configuration structure */
+typedef struct {
+    FILE *fp; /* data file */
+    int format; /* data encoding format */
+    int n; /* number of bytes staged in buffer */
+    unsigned long long offset; /* offset of the next appended data array */
+    unsigned char byte[PVBUFN]; /* staged binary data */
+    char code[PVBUFN / 3 * 4]; /* base64 encoded data */
+} PvStream; /* buffered data stream */
+typedef struct {
+    PvStr rname; /* data file root name, empty if not in use */
+    long offset; /* position of the closing tags in the transient case file */
+} PvIndex; /* transient case file index */
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
@@ -50,6 +79,10 @@ typedef struct {
  */
 extern void WriteStructuredDataParaview(const Time *, const Space *, const Model *);
 extern void ReadStructuredDataParaview(Time *, Space *, const Model *);
+/*
+ * Statistics data writer
+ */
+extern void WriteStatisticsDataParaview(const Time *, const Space *, const Model *);
 /*
  * Poly data writer and reader
  */
@@ -13,6 +13,7 @@
  ****************************************************************************/
 #include "paraview.h"
 #include <stdio.h> /* standard library for input and output */
+#include <stdlib.h> /* dynamic memory allocation and exit */
 #include <string.h> /* manipulating strings */
 #include "data_stream.h"
 #include "computational_geometry.h"
@@ -23,6 +24,8 @@
  ****************************************************************************/
 static void ReadCaseFile(Time *, PvSet *);
 static void ReadStructuredData(Space *, const Model *, PvSet *);
+static void ReadDataArray(const long, FILE *, PvReal [restrict]);
+static void DecodeBase64(const long, FILE *, unsigned char [restrict]);
 static void PointPolyDataReader(const Time *, Geometry *const);
 static void ReadPointPolyData(const int, const int, Geometry *const, PvSet *);
 static void PolygonPolyDataReader(const Time *, Geometry *const);
@@ -46,6 +49,9 @@ void ReadStructuredDataParaview(Time *time, Space *space, const Model *model)
         .vecN = 0,
         .vec = {{'\0'}},
     };
+    if (1 < space->part.rankN) { /* a file series for each processor */
+        snprintf(pvSet.rname, sizeof(PvStr), "field_%04d_", space->part.rank);
+    }
     snprintf(pvSet.bname, sizeof(PvStr), pvSet.fmt, pvSet.rname, time->dataC);
     ReadCaseFile(time, &pvSet);
     ReadStructuredData(space, model, &pvSet);
@@ -64,41 +70,50 @@ static void ReadCaseFile(Time *time, PvSet *pvSet)
 static void ReadStructuredData(Space *space, const Model *model, PvSet *pvSet)
 {
     snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
-    FILE *fp = Fopen(pvSet->fname, "r");
+    FILE *fp = Fopen(pvSet->fname, "rb");
     PvReal data = 0.0; /* paraview scalar data */
-    const char *fmtI = ParseFormat("%lg");
     const Partition *const part = &(space->part);
     Node *const node = space->node;
-    Real *restrict U = NULL;
+    Real U[DIMU] = {0.0};
     int idx = 0; /* linear array index math variable */
+    const long nodeN = (long)(part->ns[PIO][X][MAX] - part->ns[PIO][X][MIN]) *
+        (part->ns[PIO][Y][MAX] - part->ns[PIO][Y][MIN]) * (part->ns[PIO][Z][MAX] - part->ns[PIO][Z][MIN]);
+    PvReal *buf = AssignStorage(nodeN * sizeof(*buf));
+    long m = 0; /* data count */
     /* get rid of redundant lines */
     ReadInLine(fp, "<PointData>");
     for (int s = 0; s < pvSet->scaN; ++s) {
-        Sread(fp, 0, "");
+        ReadDataArray(nodeN, fp, buf);
+        m = 0;
         for (int k = part->ns[PAL][Z][MIN]; k < part->ns[PAL][Z][MAX]; ++k) {
             for (int j = part->ns[PAL][Y][MIN]; j < part->ns[PAL][Y][MAX]; ++j) {
                 for (int i = part->ns[PAL][X][MIN]; i < part->ns[PAL][X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
                     if (0 == s) {
                         /* geometric field initializer */
-                        node[idx].did = NONE;
-                        node[idx].fid = NONE;
-                        node[idx].lid = NONE;
-                        node[idx].gst = NONE;
-                        memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
+                        node->did[idx] = NONE;
+                        node->fid[idx] = NONE;
+                        node->lid[idx] = NONE;
+                        node->gst[idx] = NONE;
+                        for (int t = 0; t < node->levelN; ++t) {
+                            for (int n = 0; n < DIMU; ++n) {
+                                memset(node->U[t][n] + idx, 1, sizeof(Real));
+                            }
+                        }
                         if (InPartBox(k, j, i, part->ns[PIN])) {
-                            node[idx].did = 0;
-                            node[idx].fid = 0;
-                            node[idx].lid = 0;
-                            node[idx].gst = 0;
+                            node->did[idx] = 0;
+                            node->fid[idx] = 0;
+                            node->lid[idx] = 0;
+                            node->gst[idx] = 0;
                         }
                     }
                     if (!InPartBox(k, j, i, part->ns[PIO])) {
                         continue;
                     }
                     /* data field initializer */
-                    U = node[idx].U[TO];
-                    Fscanf(fp, 1, fmtI, &data);
+                    LoadU(TO, idx, node, U);
+                    data = buf[m];
+                    ++m;
                     switch (s) {
                         case 0: /* rho */
                             U[0] = data;
@@ -119,13 +134,106 @@ static void ReadStructuredData(Space *space, const Model *model, PvSet *pvSet)
                         default:
                             break;
                     }
+                    StoreU(TO, idx, U, node);
                 }
             }
         }
+    }
+    RetrieveStorage(buf);
+    fclose(fp);
+    return;
+}
+/*
+ * Read the data array starting at the next line. The encoding format is
+ * identified by the array header, thus data written in any format can be
+ * read back. A binary array is read into a block at once. An appended
+ * array is located by its offset from the start of the appended data, and
+ * the file is positioned back after the array header for the next array.
+ */
+static void ReadDataArray(const long n, FILE *fp, PvReal data[restrict])
+{
+    String str = {'\0'}; /* store the current read line */
+    const char *fmtI = ParseFormat("%lg");
+    const char *offset = NULL; /* offset of appended data array */
+    unsigned long long byteN = 0; /* byte size of binary data array */
+    float value = 0.0; /* binary data are in Float32 */
+    const long blockN = sizeof(byteN) + n * sizeof(value); /* byte size of header and data */
+    unsigned char *block = NULL;
+    fpos_t pos; /* store position indicator */
+    int c = 0; /* character */
+    if ((NULL == fgets(str, sizeof str, fp)) || (NULL == strstr(str, "<DataArray"))) {
+        ShowError("data array not found: %s", str);
+    }
+    if (NULL != strstr(str, "format=\"ascii\"")) {
+        for (long m = 0; m < n; ++m) {
+            Fscanf(fp, 1, fmtI, data + m);
+        }
         Sread(fp, 0, ""); /* get rid of the end of line of data */
         Sread(fp, 0, "");
+        return;
+    }
+    block = AssignStorage(blockN);
+    if (NULL != strstr(str, "format=\"binary\"")) {
+        DecodeBase64(blockN, fp, block);
+        Sread(fp, 0, ""); /* get rid of the end of line of data */
+        Sread(fp, 0, "");
+    } else {
+        offset = strstr(str, "offset=\"");
+        if ((NULL == strstr(str, "format=\"appended\"")) || (NULL == offset)) {
+            ShowError("unknown data array format: %s", str);
+        }
+        fgetpos(fp, &pos);
+        ReadInLine(fp, "<AppendedData encoding=\"raw\">");
+        while ((EOF != (c = fgetc(fp))) && ('_' != c)) {
+            continue;
+        }
+        fseek(fp, atol(offset + strlen("offset=\"")), SEEK_CUR);
+        Fread(block, 1, blockN, fp);
+        fsetpos(fp, &pos);
+    }
+    memcpy(&byteN, block, sizeof(byteN));
+    if (n * sizeof(value) != byteN) {
+        ShowError("data array size mismatch: %s", str);
+    }
+    for (long m = 0; m < n; ++m) {
+        memcpy(&value, block + sizeof(byteN) + m * sizeof(value), sizeof(value));
+        data[m] = value;
+    }
+    RetrieveStorage(block);
+    return;
+}
+/*
+ * Decode base64 characters into n bytes, with whitespace skipped and each
+ * padding character taken as zero.
+ */
+static void DecodeBase64(const long n, FILE *fp, unsigned char byte[restrict])
+{
+    const char *table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const char *code = NULL;
+    unsigned long quad = 0; /* a group of four characters */
+    int c = 0; /* character */
+    int k = 0; /* number of characters in group */
+    for (long m = 0; m < n;) {
+        c = fgetc(fp);
+        if (EOF == c) {
+            ShowError("unexpected end of base64 data");
+        }
+        code = strchr(table, c);
+        if (('=' != c) && ((NULL == code) || ('\0' == c))) {
+            continue;
+        }
+        quad = (quad << 6) | (('=' == c) ? 0 : (unsigned long)(code - table));
+        ++k;
+        if (4 != k) {
+            continue;
+        }
+        for (int t = 16; (0 <= t) && (m < n); t = t - 8) {
+            byte[m] = (quad >> t) & 255;
+            ++m;
+        }
+        quad = 0;
+        k = 0;
     }
-    fclose(fp);
     return;
 }
 void ReadPolyDataParaview(const Time *time, Geometry *const geo)
@@ -205,7 +313,6 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
         Sread(fp, 1, "%*s %*s %d", &(poly->faceN));
         Sread(fp, 0, "");
         AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, poly);
-        poly->edgeN = 0; /* reset edge count before applying edge adding */
         Sread(fp, 0, "");
         Sread(fp, 0, "");
         Sread(fp, 0, "");
@@ -228,11 +335,8 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
         Sread(fp, 0, "");
         for (int n = 0; n < poly->faceN; ++n) {
             Fscanf(fp, 3, "%d %d %d", &(poly->f[n][0]), &(poly->f[n][1]), &(poly->f[n][2]));
-            AddEdge(poly->f[n][0], poly->f[n][1], n, poly);
-            AddEdge(poly->f[n][1], poly->f[n][2], n, poly);
-            AddEdge(poly->f[n][2], poly->f[n][0], n, poly);
         }
-        QuickSortEdge(poly->edgeN, poly->e);
+        BuildEdgeList(poly);
         ReadInLine(fp, "</Piece>");
     }
     ReadInLine(fp, "<!--");
@@ -15,14 +15,21 @@
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
 #include "data_stream.h"
+#include "statistics.h"
+#include "computational_geometry.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static void InitializeTransientCaseFile(PvSet *);
+static void InitializeTransientCaseFile(const Time *, PvSet *, PvIndex *);
 static void WriteCaseFile(const Time *, PvSet *);
+static PvIndex *FindIndex(const int);
 static void WriteStructuredData(const Space *, const Model *, PvSet *);
+static void WriteDataArray(const int, const Space *, const Model *, const PvSet *, PvStream *);
+static void PushData(const PvReal, PvStream *);
+static void PushBytes(const void *, const int, PvStream *);
+static void FlushStream(const int, PvStream *);
 static void PointPolyDataWriter(const Time *, const Geometry *const);
 static void WritePointPolyData(const int, const int, const Geometry *const, PvSet *);
 static void PolygonPolyDataWriter(const Time *, const Geometry *const);
@@ -34,6 +41,7 @@ void WriteStructuredDataParaview(const Time *time, const Space *space, const Mod
 {
     PvSet pvSet = { /* initialize environment */
         .rname = "field",
+        .series = PVFIELD,
         .bname = {'\0'},
         .fname = {'\0'},
         .fext = ".vts",
@@ -45,25 +53,97 @@ void WriteStructuredDataParaview(const Time *time, const Space *space, const Mod
         .sca = {"rho", "u", "v", "w", "p", "T", "did", "fid", "lid", "gst"},
         .vecN = 1,
         .vec = {"Vel"},
+        .format = time->dataFormat,
     };
+    const int one = 1;
+    if (1 != *(const unsigned char *)&one) { /* binary data follow the byte order of host */
+        snprintf(pvSet.byteOrder, sizeof(PvStr), "BigEndian");
+    }
+    if (1 < space->part.rankN) { /* a file series for each processor */
+        snprintf(pvSet.rname, sizeof(PvStr), "field_%04d_", space->part.rank);
+    }
     snprintf(pvSet.bname, sizeof(PvStr), pvSet.fmt, pvSet.rname, time->dataC);
-    if (0 == time->stepC) { /* initialization step */
-        InitializeTransientCaseFile(&pvSet);
+    WriteCaseFile(time, &pvSet);
+    WriteStructuredData(space, model, &pvSet);
+    return;
+}
+void WriteStatisticsDataParaview(const Time *time, const Space *space, const Model *model)
+{
+    PvSet pvSet = { /* initialize environment */
+        .rname = "stats",
+        .series = PVSTATS,
+        .bname = {'\0'},
+        .fname = {'\0'},
+        .fext = ".vts",
+        .fmt = "%s%05d",
+        .intType = "Int32",
+        .floatType = "Float32",
+        .byteOrder = "LittleEndian",
+        .scaN = 15,
+        .sca = {"rho", "u", "v", "w", "p", "T", "rho_rms", "u_rms", "v_rms", "w_rms", "p_rms", "T_rms",
+            "uv", "uw", "vw"},
+        .vecN = 1,
+        .vec = {"Vel"},
+        .format = time->dataFormat,
+        .stat = space->node->stat,
+        .sampleN = time->statC,
+    };
+    const int one = 1;
+    if (1 != *(const unsigned char *)&one) { /* binary data follow the byte order of host */
+        snprintf(pvSet.byteOrder, sizeof(PvStr), "BigEndian");
+    }
+    if (1 < space->part.rankN) { /* a file series for each processor */
+        snprintf(pvSet.rname, sizeof(PvStr), "stats_%04d_", space->part.rank);
     }
+    snprintf(pvSet.bname, sizeof(PvStr), pvSet.fmt, pvSet.rname, time->dataC);
     WriteCaseFile(time, &pvSet);
     WriteStructuredData(space, model, &pvSet);
     return;
 }
-static void InitializeTransientCaseFile(PvSet *pvSet)
+/*
+ * The transient case file lists the exports before the current one, taken
+ * from their own case files. Hence a restart drops exports after the
+ * restart point, and a transient case file damaged by an interrupted run
+ * is repaired. It is written to a temporary file and then renamed.
+ */
+static void InitializeTransientCaseFile(const Time *time, PvSet *pvSet, PvIndex *index)
 {
-    snprintf(pvSet->fname, sizeof(PvStr), "%s.pvd", pvSet->rname);
-    FILE *fp = Fopen(pvSet->fname, "w");
+    String str = {'\0'}; /* store the current read line */
+    String tname = {'\0'}; /* temporary file name */
+    String fname = {'\0'}; /* case file name of an earlier export */
+    PvStr bname = {'\0'}; /* base name of an earlier export */
+    snprintf(index->rname, sizeof(PvStr), "%s", pvSet->rname);
+    snprintf(tname, sizeof tname, "%s.tmp", pvSet->rname);
+    FILE *fp = Fopen(tname, "w");
     fprintf(fp, "<?xml version=\"1.0\"?>\n");
     fprintf(fp, "<VTKFile type=\"Collection\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
     fprintf(fp, "  <Collection>\n");
+    for (int n = 0; n < time->dataC; ++n) {
+        snprintf(bname, sizeof(PvStr), pvSet->fmt, pvSet->rname, n);
+        snprintf(fname, sizeof fname, "%s.pvd", bname);
+        FILE *fc = fopen(fname, "r");
+        if (NULL == fc) {
+            continue;
+        }
+        int copy = 0; /* whether in the collection */
+        while ((NULL != fgets(str, sizeof str, fc)) && (NULL == strstr(str, "</Collection>"))) {
+            if (copy) {
+                fputs(str, fp);
+            }
+            if (NULL != strstr(str, "<Collection>")) {
+                copy = 1;
+            }
+        }
+        fclose(fc);
+    }
+    index->offset = ftell(fp);
     fprintf(fp, "  </Collection>\n");
     fprintf(fp, "</VTKFile>\n");
     fclose(fp);
+    snprintf(fname, sizeof fname, "%s.pvd", pvSet->rname);
+    if (0 != rename(tname, fname)) {
+        ShowError("failed to rename file: %s", tname);
+    }
     return;
 }
 static void WriteCaseFile(const Time *time, PvSet *pvSet)
@@ -82,125 +162,267 @@ static void WriteCaseFile(const Time *time, PvSet *pvSet)
     fprintf(fp, "  Step %d\n", time->stepC);
     fprintf(fp, "-->\n");
     fclose(fp);
-    /* add case to the transient case */
+    /* add case to the transient case, the first export of a run builds it */
+    PvIndex *index = FindIndex(pvSet->series);
+    if ('\0' == index->rname[0]) {
+        InitializeTransientCaseFile(time, pvSet, index);
+    }
     snprintf(pvSet->fname, sizeof(PvStr), "%s.pvd", pvSet->rname);
     fp = Fopen(pvSet->fname, "r+");
-    /* seek the target line for adding information */
-    WriteToLine(fp, "</Collection>");
-    /* append informatiom */
+    /*
+     * Overwrite the closing tags at the recorded position, rather than
+     * searching the file, so adding an export costs the same however many
+     * exports are listed. The entry and the closing tags go out in a single
+     * buffered write.
+     */
+    fseek(fp, index->offset, SEEK_SET);
     fprintf(fp, "    <DataSet timestep=\"%.6g\" group=\"\" part=\"0\"\n", time->now);
     fprintf(fp, "             file=\"%s%s\"/>\n", pvSet->bname, pvSet->fext);
+    index->offset = ftell(fp);
     fprintf(fp, "  </Collection>\n");
     fprintf(fp, "</VTKFile>\n");
     fclose(fp);
     return;
 }
+/*
+ * Return the index of the transient case file of a series, which is not
+ * in use until the file is built. Each series has its own index, so a
+ * new series only needs to be added to the series enumeration.
+ */
+static PvIndex *FindIndex(const int series)
+{
+    static PvIndex index[PVINDEXN]; /* indices of transient case files */
+    if ((0 > series) || (PVINDEXN <= series)) {
+        ShowError("unknown transient case file series: %d", series);
+    }
+    return index + series;
+}
+/*
+ * Data arrays are written in ascii, appended raw binary, or inline base64
+ * encoded binary. A binary array is preceded by a UInt64 header of its byte
+ * size, and base64 encodes the header and the data as one stream. Values
+ * of each array are generated in a single pass and staged in a buffer,
+ * which is flushed to the file in blocks.
+ */
 static void WriteStructuredData(const Space *space, const Model *model, PvSet *pvSet)
 {
     snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
-    FILE *fp = Fopen(pvSet->fname, "w");
-    PvReal data = 0.0; /* paraview scalar data */
-    PvReal Vec[3] = {0.0}; /* paraview vector data */
+    FILE *fp = Fopen(pvSet->fname, "wb");
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
-    const Real *restrict U = NULL;
-    int idx = 0; /* linear array index math variable */
+    const int arrN = pvSet->scaN + pvSet->vecN + 1; /* scalars, vectors, and points */
     IntVec ne = {0}; /* i, j, k node number in each part */
     ne[X] = part->ns[PIO][X][MAX] - part->ns[PIO][X][MIN] - 1;
     ne[Y] = part->ns[PIO][Y][MAX] - part->ns[PIO][Y][MIN] - 1;
     ne[Z] = part->ns[PIO][Z][MAX] - part->ns[PIO][Z][MIN] - 1;
+    const unsigned long long nodeN = (unsigned long long)(ne[X] + 1) * (ne[Y] + 1) * (ne[Z] + 1);
+    PvStream stream = {.fp = fp, .format = pvSet->format, .n = 0, .offset = 0};
+    unsigned long long byteN = 0; /* byte size of binary data array */
+    int compN = 0; /* number of components */
+    const char *name = NULL;
     fprintf(fp, "<?xml version=\"1.0\"?>\n");
-    fprintf(fp, "<VTKFile type=\"StructuredGrid\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
+    if (PVASCII == pvSet->format) {
+        fprintf(fp, "<VTKFile type=\"StructuredGrid\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
+    } else {
+        fprintf(fp, "<VTKFile type=\"StructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\">\n",
+                pvSet->byteOrder);
+    }
     fprintf(fp, "  <StructuredGrid WholeExtent=\"%d %d %d %d %d %d\">\n", 0, ne[X], 0, ne[Y], 0, ne[Z]);
     fprintf(fp, "    <Piece Extent=\"%d %d %d %d %d %d\">\n", 0, ne[X], 0, ne[Y], 0, ne[Z]);
     fprintf(fp, "      <PointData>\n");
-    for (int s = 0; s < pvSet->scaN; ++s) {
-        fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\" format=\"ascii\">\n", pvSet->floatType, pvSet->sca[s]);
-        fprintf(fp, "          ");
-        for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
-            for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
-                for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    U = node[idx].U[TO];
-                    switch (s) {
-                        case 0: /* rho */
-                            data = U[0];
-                            break;
-                        case 1: /* u */
-                            data = U[1] / U[0];
-                            break;
-                        case 2: /* v */
-                            data = U[2] / U[0];
-                            break;
-                        case 3: /* w */
-                            data = U[3] / U[0];
-                            break;
-                        case 4: /* p */
-                            data = ComputePressure(model->gamma, U);
-                            break;
-                        case 5: /* T */
-                            data = ComputeTemperature(model->cv, U);
-                            break;
-                        case 6: /* node flag */
-                            data = node[idx].did;
-                            break;
-                        case 7: /* face flag */
-                            data = node[idx].fid;
-                            break;
-                        case 8: /* layer flag */
-                            data = node[idx].lid;
-                            break;
-                        case 9: /* ghost flag */
-                            data = node[idx].gst;
-                            break;
-                        default:
-                            break;
-                    }
-                    fprintf(fp, "%.6g ", data);
-                }
-            }
+    for (int s = 0; s < arrN; ++s) {
+        if (arrN - 1 == s) {
+            fprintf(fp, "      </PointData>\n");
+            fprintf(fp, "      <CellData>\n");
+            fprintf(fp, "      </CellData>\n");
+            fprintf(fp, "      <Points>\n");
+        }
+        compN = (pvSet->scaN > s) ? 1 : 3;
+        name = (pvSet->scaN > s) ? pvSet->sca[s] : ((arrN - 1 > s) ? pvSet->vec[s - pvSet->scaN] : "points");
+        byteN = nodeN * compN * sizeof(float);
+        fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\"", pvSet->floatType, name);
+        if (1 < compN) {
+            fprintf(fp, " NumberOfComponents=\"%d\"", compN);
+        }
+        switch (pvSet->format) {
+            case PVRAW:
+                fprintf(fp, " format=\"appended\" offset=\"%llu\"/>\n", stream.offset);
+                stream.offset = stream.offset + sizeof(byteN) + byteN;
+                continue;
+            case PVBASE64:
+                fprintf(fp, " format=\"binary\">\n");
+                fprintf(fp, "          ");
+                PushBytes(&byteN, sizeof(byteN), &stream);
+                WriteDataArray(s, space, model, pvSet, &stream);
+                FlushStream(1, &stream);
+                break;
+            default:
+                fprintf(fp, " format=\"ascii\">\n");
+                fprintf(fp, "          ");
+                WriteDataArray(s, space, model, pvSet, &stream);
+                break;
         }
         fprintf(fp, "\n        </DataArray>\n");
     }
-    for (int s = 0; s < pvSet->vecN; ++s) {
-        fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType, pvSet->vec[s]);
-        fprintf(fp, "          ");
-        for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
-            for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
-                for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    U = node[idx].U[TO];
+    fprintf(fp, "      </Points>\n");
+    fprintf(fp, "    </Piece>\n");
+    fprintf(fp, "  </StructuredGrid>\n");
+    if (PVRAW == pvSet->format) {
+        fprintf(fp, "  <AppendedData encoding=\"raw\">\n");
+        fprintf(fp, "   _");
+        for (int s = 0; s < arrN; ++s) {
+            compN = (pvSet->scaN > s) ? 1 : 3;
+            byteN = nodeN * compN * sizeof(float);
+            PushBytes(&byteN, sizeof(byteN), &stream);
+            WriteDataArray(s, space, model, pvSet, &stream);
+        }
+        FlushStream(1, &stream);
+        fprintf(fp, "\n  </AppendedData>\n");
+    }
+    fprintf(fp, "</VTKFile>\n");
+    fclose(fp);
+    return;
+}
+static void WriteDataArray(const int s, const Space *space, const Model *model, const PvSet *pvSet,
+        PvStream *stream)
+{
+    PvReal data = 0.0; /* paraview scalar data */
+    PvReal Vec[3] = {0.0}; /* paraview vector data */
+    const Partition *const part = &(space->part);
+    const Node *const node = space->node;
+    Real U[DIMU] = {0.0};
+    const Real *stat = NULL; /* running statistics of a node */
+    int idx = 0; /* linear array index math variable */
+    for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
+        for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
+            for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
+                if (pvSet->scaN + pvSet->vecN == s) { /* points */
+                    Vec[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->no[X]);
+                    Vec[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->no[Y]);
+                    Vec[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->no[Z]);
+                    PushData(Vec[X], stream);
+                    PushData(Vec[Y], stream);
+                    PushData(Vec[Z], stream);
+                    continue;
+                }
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (NULL != pvSet->stat) { /* statistics, the vector is the mean velocity */
+                    stat = pvSet->stat + (size_t)idx * DIMSTAT;
+                    if (pvSet->scaN <= s) {
+                        PushData(ComputeStatistic(1, pvSet->sampleN, stat), stream);
+                        PushData(ComputeStatistic(2, pvSet->sampleN, stat), stream);
+                        PushData(ComputeStatistic(3, pvSet->sampleN, stat), stream);
+                        continue;
+                    }
+                    PushData(ComputeStatistic(s, pvSet->sampleN, stat), stream);
+                    continue;
+                }
+                LoadU(TO, idx, node, U);
+                if (pvSet->scaN <= s) { /* velocity vector */
                     Vec[X] = U[1] / U[0];
                     Vec[Y] = U[2] / U[0];
                     Vec[Z] = U[3] / U[0];
-                    fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
+                    PushData(Vec[X], stream);
+                    PushData(Vec[Y], stream);
+                    PushData(Vec[Z], stream);
+                    continue;
+                }
+                switch (s) {
+                    case 0: /* rho */
+                        data = U[0];
+                        break;
+                    case 1: /* u */
+                        data = U[1] / U[0];
+                        break;
+                    case 2: /* v */
+                        data = U[2] / U[0];
+                        break;
+                    case 3: /* w */
+                        data = U[3] / U[0];
+                        break;
+                    case 4: /* p */
+                        data = ComputePressure(model->gamma, U);
+                        break;
+                    case 5: /* T */
+                        data = ComputeTemperature(model->cv, U);
+                        break;
+                    case 6: /* node flag */
+                        data = node->did[idx];
+                        break;
+                    case 7: /* face flag */
+                        data = node->fid[idx];
+                        break;
+                    case 8: /* layer flag */
+                        data = node->lid[idx];
+                        break;
+                    case 9: /* ghost flag */
+                        data = node->gst[idx];
+                        break;
+                    default:
+                        break;
                 }
+                PushData(data, stream);
             }
         }
-        fprintf(fp, "\n        </DataArray>\n");
     }
-    fprintf(fp, "      </PointData>\n");
-    fprintf(fp, "      <CellData>\n");
-    fprintf(fp, "      </CellData>\n");
-    fprintf(fp, "      <Points>\n");
-    fprintf(fp, "        <DataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType);
-    fprintf(fp, "          ");
-    for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
-        for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
-            for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
-                Vec[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
-                Vec[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
-                Vec[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
-                fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
-            }
+    return;
+}
+static void PushData(const PvReal data, PvStream *stream)
+{
+    if (PVASCII == stream->format) {
+        fprintf(stream->fp, "%.6g ", data);
+        return;
+    }
+    const float value = data; /* binary data are in Float32 */
+    PushBytes(&value, sizeof(value), stream);
+    return;
+}
+static void PushBytes(const void *data, const int n, PvStream *stream)
+{
+    if (PVBUFN < stream->n + n) {
+        FlushStream(0, stream);
+    }
+    memcpy(stream->byte + stream->n, data, n);
+    stream->n = stream->n + n;
+    return;
+}
+/*
+ * Flush staged bytes. Base64 encodes every three bytes into four characters,
+ * so the remaining bytes are kept for the next block, unless the stream ends
+ * and they are padded.
+ */
+static void FlushStream(const int end, PvStream *stream)
+{
+    const char *table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const unsigned char *b = stream->byte;
+    unsigned long tri = 0; /* a group of three bytes */
+    int m = 0; /* number of encoded characters */
+    int n = 0; /* number of bytes encoded */
+    if (PVBASE64 != stream->format) {
+        fwrite(stream->byte, 1, stream->n, stream->fp);
+        stream->n = 0;
+        return;
+    }
+    for (n = 0; n + 3 <= stream->n; n = n + 3) {
+        tri = ((unsigned long)b[n] << 16) | ((unsigned long)b[n+1] << 8) | b[n+2];
+        stream->code[m++] = table[(tri >> 18) & 63];
+        stream->code[m++] = table[(tri >> 12) & 63];
+        stream->code[m++] = table[(tri >> 6) & 63];
+        stream->code[m++] = table[tri & 63];
+    }
+    if (end && (n < stream->n)) {
+        tri = (unsigned long)b[n] << 16;
+        if (n + 1 < stream->n) {
+            tri = tri | ((unsigned long)b[n+1] << 8);
         }
+        stream->code[m++] = table[(tri >> 18) & 63];
+        stream->code[m++] = table[(tri >> 12) & 63];
+        stream->code[m++] = (n + 1 < stream->n) ? table[(tri >> 6) & 63] : '=';
+        stream->code[m++] = '=';
+        n = stream->n;
     }
-    fprintf(fp, "\n        </DataArray>\n");
-    fprintf(fp, "      </Points>\n");
-    fprintf(fp, "    </Piece>\n");
-    fprintf(fp, "  </StructuredGrid>\n");
-    fprintf(fp, "</VTKFile>\n");
-    fclose(fp);
+    fwrite(stream->code, 1, m, stream->fp);
+    memmove(stream->byte, stream->byte + n, stream->n - n);
+    stream->n = stream->n - n;
     return;
 }
 void WritePolyDataParaview(const Time *time, const Geometry *const geo)
@@ -217,6 +439,7 @@ static void PointPolyDataWriter(const Time *time, const Geometry *const geo)
 {
     PvSet pvSet = { /* initialize environment */
         .rname = "geo_sph",
+        .series = PVSPH,
         .bname = {'\0'},
         .fname = {'\0'},
         .fext = ".vtp",
@@ -230,9 +453,6 @@ static void PointPolyDataWriter(const Time *time, const Geometry *const geo)
         .vec = {"Vel"},
     };
     snprintf(pvSet.bname, sizeof(PvStr), pvSet.fmt, pvSet.rname, time->dataC);
-    if (0 == time->stepC) { /* initialization step */
-        InitializeTransientCaseFile(&pvSet);
-    }
     WriteCaseFile(time, &pvSet);
     WritePointPolyData(0, geo->sphN, geo, &pvSet);
     return;
@@ -318,6 +538,7 @@ static void PolygonPolyDataWriter(const Time *time, const Geometry *const geo)
 {
     PvSet pvSet = { /* initialize environment */
         .rname = "geo_stl",
+        .series = PVSTL,
         .bname = {'\0'},
         .fname = {'\0'},
         .fext = ".vtp",
@@ -331,9 +552,6 @@ static void PolygonPolyDataWriter(const Time *time, const Geometry *const geo)
         .vec = {{'\0'}},
     };
     snprintf(pvSet.bname, sizeof(PvStr), pvSet.fmt, pvSet.rname, time->dataC);
-    if (0 == time->stepC) { /* initialization step */
-        InitializeTransientCaseFile(&pvSet);
-    }
     WriteCaseFile(time, &pvSet);
     WritePolygonPolyData(geo->sphN, geo->totN, geo, &pvSet);
     return;
@@ -343,6 +561,7 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
     snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
     FILE *fp = Fopen(pvSet->fname, "w");
     PvReal Vec[3] = {0.0}; /* paraview vector data */
+    RealVec pw = {0.0}; /* vertex in world frame */
     const Polyhedron *poly = NULL;
     fprintf(fp, "<?xml version=\"1.0\"?>\n");
     fprintf(fp, "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
@@ -363,9 +582,10 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
         fprintf(fp, "        <DataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType);
         fprintf(fp, "          ");
         for (int n = 0; n < poly->vertN; ++n) {
-            Vec[X] = poly->v[n][X];
-            Vec[Y] = poly->v[n][Y];
-            Vec[Z] = poly->v[n][Z];
+            TransformToWorld(poly, poly->v[n], pw);
+            Vec[X] = pw[X];
+            Vec[Y] = pw[Y];
+            Vec[Z] = pw[Z];
             fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
         }
         fprintf(fp, "\n        </DataArray>\n");
@@ -14,6 +14,7 @@
 #include "postprocess.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
+#include "data_exchange.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
@@ -27,6 +28,7 @@ int Postprocess(Time *time, Space *space, Model *model)
     ShowInfo("Postprocessing...\n");
     ShowInfo("  releasing memory...\n");
     ReleaseProgramMemory(time, space, model);
+    FinalizeDataExchange();
     ShowInfo("  computing finished, successfully exit.\n");
     ShowInfo("Session");
     return 0;
@@ -44,9 +46,23 @@ static void ReleaseProgramMemory(Time *time, Space *space, Model *model)
         RetrieveStorage(poly->Ne);
         RetrieveStorage(poly->v);
         RetrieveStorage(poly->Nv);
+        RetrieveStorage(poly->bvh);
+        RetrieveStorage(poly->fo);
     }
     RetrieveStorage(geo->poly);
     RetrieveStorage(geo->col);
+    RetrieveStorage(geo->bin.eb);
+    RetrieveStorage(geo->bin.cell);
+    RetrieveStorage(geo->bin.head);
+    RetrieveStorage(geo->bin.top);
+    RetrieveStorage(geo->bin.list);
+    RetrieveStorage(geo->bin.pair);
+    RetrieveStorage(geo->pair);
+    RetrieveStorage(geo->drift);
+    RetrieveStorage(geo->ghost);
+    RetrieveStorage(geo->ghostO);
+    RetrieveStorage(geo->sten);
+    RetrieveStorage(geo->stenW);
     /* space related */
     Partition *const part = &(space->part);
     RetrieveStorage(part->typeBC);
@@ -55,8 +71,11 @@ static void ReleaseProgramMemory(Time *time, Space *space, Model *model)
     RetrieveStorage(part->typeIC);
     RetrieveStorage(part->posIC);
     RetrieveStorage(part->varIC);
+    RetrieveStorage(space->node->pool);
+    RetrieveStorage(space->node->stat);
     RetrieveStorage(space->node);
     /* time related */
+    RetrieveStorage(time->sp);
     RetrieveStorage(time->lp);
     RetrieveStorage(time->pp);
     /* model related */
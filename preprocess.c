@@ -14,6 +14,7 @@
 #include "preprocess.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
+#include <stdint.h> /* fixed width integer types */
 #include "case_loader.h"
 #include "cfd_parameters.h"
 #include "domain_partition.h"
@@ -21,7 +22,8 @@
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static void AllocateProgramMemory(Space *, Model *);
+static void AllocateProgramMemory(const Time *, Space *, Model *);
+static void AllocateFieldMemory(const int, const int, Node *const);
 /****************************************************************************
  * Function Definitions
  ****************************************************************************/
@@ -36,7 +38,7 @@ int Preprocess(Time *time, Space *space, Model *model)
     ShowInfo("  partitioning domain...\n");
     PartitionDomain(space);
     ShowInfo("  allocating memory...\n");
-    AllocateProgramMemory(space, model);
+    AllocateProgramMemory(time, space, model);
     ShowInfo("Session");
     return 0;
 }
@@ -44,18 +46,54 @@ int Preprocess(Time *time, Space *space, Model *model)
  * Allocate memory for the remaining unassigned data.
  * Storage retrieving is done in the postprocessor.
  */
-static void AllocateProgramMemory(Space *space, Model *model)
+static void AllocateProgramMemory(const Time *time, Space *space, Model *model)
 {
     Partition *const part = &(space->part);
     Geometry *const geo = &(space->geo);
     const int totN = part->n[X] * part->n[Y] * part->n[Z];
-    space->node = AssignStorage(totN * sizeof(*space->node));
+    /* the classical RK3 keeps two intermediate levels, others only need one */
+    const int levelN = (RKTHREE == model->tScheme) ? 3 : 2;
+    space->node = AssignStorage(sizeof(*space->node));
+    AllocateFieldMemory(totN, levelN, space->node);
+    if (0 != time->statW) {
+        space->node->stat = AssignStorage(totN * DIMSTAT * sizeof(*space->node->stat));
+    }
     if (0 != geo->totN) {
         geo->col = AssignStorage(geo->totN * sizeof(*geo->col));
+        geo->drift = AssignStorage(geo->totN * sizeof(*geo->drift));
         geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
     }
     model->mat = AssignStorage(sizeof(*model->mat));
     return;
 }
+/*
+ * Field data are stored as a structure of arrays: one array for each
+ * conservative variable at each time level and for each geometric flag.
+ * All arrays are carved from a single storage block and each one starts
+ * at an aligned address, so a sweep only streams the variables it uses
+ * and the arrays are friendly to vector loads. Only the time levels used
+ * by the temporal scheme are allocated.
+ */
+static void AllocateFieldMemory(const int totN, const int levelN, Node *const node)
+{
+    const size_t sizeI = ((totN * sizeof(int) + ALIGNB - 1) / ALIGNB) * ALIGNB;
+    const size_t sizeR = ((totN * sizeof(Real) + ALIGNB - 1) / ALIGNB) * ALIGNB;
+    node->levelN = levelN;
+    node->pool = AssignStorage(4 * sizeI + levelN * DIMU * sizeR + ALIGNB);
+    unsigned char *ptr = node->pool;
+    ptr = ptr + (ALIGNB - (uintptr_t)ptr % ALIGNB) % ALIGNB;
+    node->did = (int *)ptr;
+    node->fid = (int *)(ptr + sizeI);
+    node->lid = (int *)(ptr + 2 * sizeI);
+    node->gst = (int *)(ptr + 3 * sizeI);
+    ptr = ptr + 4 * sizeI;
+    for (int tn = 0; tn < levelN; ++tn) {
+        for (int n = 0; n < DIMU; ++n) {
+            node->U[tn][n] = (Real *)ptr;
+            ptr = ptr + sizeR;
+        }
+    }
+    return;
+}
 /* a good practice: end file with a newline */
 
@@ -15,8 +15,12 @@
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
 #include <string.h> /* manipulating strings */
+#ifdef _OPENMP
+#include <omp.h> /* openmp runtime routines */
+#endif
 #include "calculator.h"
 #include "case_generator.h"
+#include "data_exchange.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
@@ -103,6 +107,8 @@ int EnterProgram(int argc, char *argv[], Control *control, Space *space)
 static void ConfigureProgram(Control *control, Space *space)
 {
     Partition *const part = &(space->part);
+    part->rank = 0;
+    part->rankN = 1;
     switch (control->runMode) {
         case 'i': /* gui mode */
             ShowPreamble(control);
@@ -112,15 +118,39 @@ static void ConfigureProgram(Control *control, Space *space)
             part->proc[Y] = 1;
             part->proc[Z] = 1;
             part->procN = 1;
+#ifdef _OPENMP
+            omp_set_num_threads(1);
+#endif
             break;
         case 'o': /* omp mode */
-            /* fall through */
+            part->proc[X] = 1;
+            part->proc[Y] = 1;
+            part->proc[Z] = 1;
+            part->procN = control->proc[X] *
+                control->proc[Y] * control->proc[Z];
+            if (0 >= part->procN) {
+                ShowError("illegal number of threads: %d\n", part->procN);
+            }
+#ifdef _OPENMP
+            omp_set_num_threads(part->procN);
+#else
+            ShowWarning("openmp is not enabled, -fopenmp is required\n");
+            part->procN = 1;
+#endif
+            break;
         case 'm': /* mpi mode */
             part->proc[X] = control->proc[X];
             part->proc[Y] = control->proc[Y];
             part->proc[Z] = control->proc[Z];
             part->procN = control->proc[X] *
                 control->proc[Y] * control->proc[Z];
+            if (0 >= part->procN) {
+                ShowError("illegal number of processors: %d\n", part->procN);
+            }
+#ifdef _OPENMP
+            omp_set_num_threads(1);
+#endif
+            InitializeDataExchange(part);
             break;
         case 'g': /* gpu mode */
             break;
@@ -192,6 +222,8 @@ static void ShowManual(void)
     ShowInfo("        -n nprocessors    processors per dimension: nx*ny*nz\n");
     ShowInfo("NOTES:\n");
     ShowInfo("        default run mode is gui\n");
+    ShowInfo("        omp mode uses nx*ny*nz threads\n");
+    ShowInfo("        mpi mode uses nx*ny*nz processes, requires CC=mpicc\n");
     return;
 }
 /* a good practice: end file with a newline */
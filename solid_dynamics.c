@@ -20,31 +20,63 @@
 #include "immersed_boundary.h"
 #include "computational_geometry.h"
 #include "linear_system.h"
+#include "data_exchange.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static Real CountCell(const Real, const Partition *const, const Geometry *const);
 static void ApplyKinematics(const Real, const Real, Space *);
-static void ApplyCollision(Space *);
+static void ComputeAcceleration(const Real, Polyhedron *);
+static void ApplyCollision(const Real, Space *);
+static void ApplyImpact(const Real [restrict], const Polyhedron *, const int, Polyhedron *);
+static void DetectColCandidate(const Real, const Partition *const, Geometry *const,
+        int [restrict], Real [restrict][DIMS][LIMIT]);
+static void AddColCandidate(const Polyhedron *, const Real [restrict], int *, Real [restrict][LIMIT]);
+static int ListPairs(const Real [restrict], const Real, Geometry *const);
 static void DetectColState(const int, const int, const int, const int, const int,
         const int [restrict][DIMS], const Node *const, const Partition *const,
         Geometry *const);
-static void AddColObject(const int [restrict], const int, Geometry *const);
+static void AddColObject(const int [restrict], const int [restrict], const int,
+        Geometry *const);
 static void ApplyMotion(const Real, Space *);
+static void DisplacePolyhedron(const Real [restrict], const Real [restrict], Polyhedron *);
+static void ApplyContact(const Real, const Real, const Partition *const, Geometry *const,
+        const Model *);
+static void UpdateNeighbourList(const Real [restrict], const Real, const Partition *const, Geometry *const);
+static int ComputeContactGeometry(const Polyhedron *, const Polyhedron *, Real [restrict],
+        Real [restrict], Real [restrict], Real *);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
+/*
+ * Solid dynamics advances once per fluid step, and polyhedrons do not
+ * restrict the fluid time step. Surface force is held during the step, and
+ * the soft-sphere contact model sub-cycles within the step by its contact
+ * duration. The geometric field and the boundary treatment are updated at
+ * the end of the fluid step. The boundary treatment, the swept band node
+ * mapping, and the collision detection require polyhedrons to move less
+ * than a cell between updates, which is checked before the step.
+ */
 void EvolveSolidDynamics(const Real now, const Real dt, Space *space, const Model *model)
 {
     IntegrateSurfaceForce(space, model);
-    ApplyKinematics(now, dt, space);
-    if (1 != model->psi) {
-        ApplyCollision(space);
+    if (1.0 <= CountCell(dt, &(space->part), &(space->geo))) {
+        ShowError("polyhedrons move a cell or more in a step, reduce the CFL number");
+    }
+    if (3 == model->psi) {
+        ApplyContact(now, dt, &(space->part), &(space->geo), model);
+    } else {
+        ApplyKinematics(now, dt, space);
+        if (2 == model->psi) {
+            ApplyCollision(dt, space);
+        }
+        ApplyMotion(dt, space);
     }
-    ApplyMotion(dt, space);
     ComputeGeometricField(space, model);
     TreatImmersedBoundary(TO, space, model);
+    ExchangeFieldData(TO, space);
     return;
 }
 void IntegrateSurfaceForce(Space *space, const Model *model)
@@ -57,7 +89,7 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
     const Real zero = 0.0;
     const Real percent = FLT_EPSILON * FLT_EPSILON;
     Polyhedron *poly = NULL;
@@ -69,6 +101,7 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
     RealVec pO = {zero}; /* boundary point */
     RealVec pI = {zero}; /* image point */
     RealVec N = {zero}; /* normal */
+    Real U[DIMU] = {zero};
     Real Uo[DIMUo] = {zero};
     RealVec V = {zero}; /* velocity vector */
     RealVec r = {zero}; /* position vector */
@@ -76,10 +109,14 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
     RealVec Fv = {zero}; /* viscous force */
     RealVec Fs = {zero}; /* surface force */
     RealVec Tt = {zero}; /* torque */
-    RealVec fvar = {zero}; /* force offset, mean, variance */
+    Real (*stat)[FCN] = NULL; /* interfacial node counts and force statistics */
     Real Vn = zero; /* velocity projection */
     Real mu = zero; /* viscosity */
     Real ds = zero; /* infinitesimal area for integration */
+    if (0 == geo->totN) {
+        return;
+    }
+    stat = AssignStorage(geo->totN * sizeof(*stat));
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         if (0 < poly->state) { /* surface force negligible */
@@ -89,42 +126,42 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
         memset(poly->Fp, 0, DIMS * sizeof(*poly->Fp));
         memset(poly->Fv, 0, DIMS * sizeof(*poly->Fv));
         memset(poly->Tt, 0, DIMS * sizeof(*poly->Tt));
-        memset(fvar, 0, DIMS * sizeof(*fvar));
         lidN = 0;
         gstN = 0;
         /* determine search range according to bounding box of polyhedron and valid node space */
         for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], no[s]), nMin[s], nMax[s]);
+            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], no[s]), nMin[s], nMax[s]) + 1;
         }
         for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
             for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
                 for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((2 == node[idx].lid) && (n + 1 == node[idx].did)) {
+                    if ((2 == node->lid[idx]) && (n + 1 == node->did[idx])) {
                         ++lidN; /* an interfacial node of current geometry */
                     }
-                    if ((2 != node[idx].gst) || (n + 1 != node[idx].did)) {
+                    if ((2 != node->gst[idx]) || (n + 1 != node->did[idx])) {
                         continue;
                     }
                     ++gstN; /* a ghost node of current geometry */
                     /* surface force exerted by fluid (pressure + shear force) */
-                    pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                    ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
+                    pG[X] = MapPoint(i, sMin[X], d[X], no[X]);
+                    pG[Y] = MapPoint(j, sMin[Y], d[Y], no[Y]);
+                    pG[Z] = MapPoint(k, sMin[Z], d[Z], no[Z]);
+                    ComputeGeometricData(pG, node->fid[idx], poly, pO, pI, N);
                     r[X] = pO[X] - poly->O[X];
                     r[Y] = pO[Y] - poly->O[Y];
                     r[Z] = pO[Z] - poly->O[Z];
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+                    LoadU(TO, idx, node, U);
+                    MapPrimitive(model->gamma, model->gasR, U, Uo);
                     Fp[X] = Uo[4] * N[X];
                     Fp[Y] = Uo[4] * N[Y];
                     Fp[Z] = Uo[4] * N[Z];
-                    if (1 == gstN) {
-                        fvar[0] = Uo[4];
+                    if (1 == gstN) { /* offset, sum, and sum of squares */
+                        stat[n][2] = Uo[4];
                     }
-                    fvar[1] = fvar[1] + Uo[4] - fvar[0];
-                    fvar[2] = fvar[2] + (Uo[4] - fvar[0]) * (Uo[4] - fvar[0]);
+                    stat[n][3] = stat[n][3] + Uo[4] - stat[n][2];
+                    stat[n][4] = stat[n][4] + (Uo[4] - stat[n][2]) * (Uo[4] - stat[n][2]);
                     if ((zero < model->refMu) && (zero < poly->cf)) {
                         mu = model->refMu * Viscosity(Uo[5] * model->refT);
                         Cross(poly->W[TO], r, V);
@@ -151,14 +188,24 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
                 }
             }
         }
+        stat[n][0] = lidN;
+        stat[n][1] = gstN;
+    }
+    /* sum up the contributions of all processors */
+    ReduceSurfaceForce(stat, geo);
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        if (0 < poly->state) { /* surface force negligible */
+            continue;
+        }
         /* calibrate the sum of discrete forces into integration */
-        if ((0 == lidN) || (0 == gstN)) { /* no surface force exerted */
+        if ((zero == stat[n][0]) || (zero == stat[n][1])) { /* no surface force exerted */
             continue;
         }
-        ds = poly->area / lidN;
-        fvar[2] = (fvar[2] - fvar[1] * fvar[1] / gstN) / gstN; /* variance */
-        fvar[1] = fvar[1] / gstN + fvar[0]; /* mean */
-        if (percent * fvar[1] * fvar[1] > fvar[2]) { /* recover equilibrium state and ignore integration error */
+        ds = poly->area / stat[n][0];
+        stat[n][4] = (stat[n][4] - stat[n][3] * stat[n][3] / stat[n][1]) / stat[n][1]; /* variance */
+        stat[n][3] = stat[n][3] / stat[n][1] + stat[n][2]; /* mean */
+        if (percent * stat[n][3] * stat[n][3] > stat[n][4]) { /* recover equilibrium state and ignore integration error */
             ds = zero;
         }
         for (int s = 0; s < DIMS; ++s) {
@@ -167,37 +214,51 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
             poly->Tt[s] = -poly->Tt[s] * ds;
         }
     }
+    RetrieveStorage(stat);
     return;
 }
-static void ApplyKinematics(const Real now, const Real dt, Space *space)
+/*
+ * Count the cells travelled by the fastest polyhedron during dt. The speeds
+ * are estimated at the end of dt with the last acceleration. A translation
+ * is also counted in the largest cell size, which is half of the skin
+ * distance of the neighbour list, SKINN cells.
+ */
+static Real CountCell(const Real dt, const Partition *const part, const Geometry *const geo)
 {
-    Geometry *const geo = &(space->geo);
-    Polyhedron *poly = NULL;
-    Real A[DIMS][DIMS] = {{0.0}};
-    Real B[DIMS][1] = {{0.0}};
+    const Polyhedron *poly = NULL;
+    const Real dMax = MaxReal(part->d[X], MaxReal(part->d[Y], part->d[Z])); /* largest cell size */
+    RealVec V = {0.0}; /* characteristic speeds in each direction */
+    RealVec W = {0.0}; /* rotational speeds in each direction */
+    Real cell = 0.0; /* maximum cells travelled during the step */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         if (1 == poly->state) { /* stationary object */
             continue;
         }
-        if (now > poly->to) { /* end power supply */
-            memset(poly->at[TN], 0, DIMS * sizeof(*poly->at[TN]));
-            memset(poly->ar[TN], 0, DIMS * sizeof(*poly->ar[TN]));
-            poly->to = FLT_MAX; /* avoid repeating */
-        }
-        /* translation and rotational acceleration */
         for (int s = 0; s < DIMS; ++s) {
-            for (int m = 0; m < DIMS; ++m) {
-                A[s][m] = poly->I[s][m];
-            }
-            B[s][0] = poly->Tt[s] / poly->rho;
+            V[s] = fabs(poly->V[TO][s]) + fabs(poly->at[TO][s]) * dt;
+            W[s] = fabs(poly->W[TO][s]) + fabs(poly->ar[TO][s]) * dt;
         }
-        SolveLinearSystem(DIMS, A, 1, B, B);
+        cell = MaxReal(cell, (Norm(poly->V[TO]) + Norm(poly->at[TO]) * dt) * dt / dMax);
+        V[X] = V[X] + MaxReal(W[Y], W[Z]) * poly->r;
+        V[Y] = V[Y] + MaxReal(W[Z], W[X]) * poly->r;
+        V[Z] = V[Z] + MaxReal(W[X], W[Y]) * poly->r;
         for (int s = 0; s < DIMS; ++s) {
-            /* acceleration from surface force and body force */
-            poly->at[TO][s] = (poly->Fp[s] + poly->Fv[s]) / (poly->rho * poly->volume) + poly->at[TN][s] + poly->g[s];
-            poly->ar[TO][s] = B[s][0] + poly->ar[TN][s];
+            cell = MaxReal(cell, V[s] * dt / part->d[s]);
+        }
+    }
+    return cell;
+}
+static void ApplyKinematics(const Real now, const Real dt, Space *space)
+{
+    Geometry *const geo = &(space->geo);
+    Polyhedron *poly = NULL;
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        if (1 == poly->state) { /* stationary object */
+            continue;
         }
+        ComputeAcceleration(now, poly);
         /* velocity integration */
         for (int s = 0; s < DIMS; ++s) {
             /* averaged velocity during time level n and n+1 */
@@ -210,7 +271,31 @@ static void ApplyKinematics(const Real now, const Real dt, Space *space)
     }
     return;
 }
-static void ApplyCollision(Space *space)
+static void ComputeAcceleration(const Real now, Polyhedron *poly)
+{
+    Real A[DIMS][DIMS] = {{0.0}};
+    Real B[DIMS][1] = {{0.0}};
+    if (now > poly->to) { /* end power supply */
+        memset(poly->at[TN], 0, DIMS * sizeof(*poly->at[TN]));
+        memset(poly->ar[TN], 0, DIMS * sizeof(*poly->ar[TN]));
+        poly->to = FLT_MAX; /* avoid repeating */
+    }
+    /* translation and rotational acceleration */
+    for (int s = 0; s < DIMS; ++s) {
+        for (int m = 0; m < DIMS; ++m) {
+            A[s][m] = poly->I[s][m];
+        }
+        B[s][0] = poly->Tt[s] / poly->rho;
+    }
+    SolveLinearSystem(DIMS, A, 1, B, B);
+    for (int s = 0; s < DIMS; ++s) {
+        /* acceleration from surface force and body force */
+        poly->at[TO][s] = (poly->Fp[s] + poly->Fv[s]) / (poly->rho * poly->volume) + poly->at[TN][s] + poly->g[s];
+        poly->ar[TO][s] = B[s][0] + poly->ar[TN][s];
+    }
+    return;
+}
+static void ApplyCollision(const Real dt, Space *space)
 {
     const Partition *const part = &(space->part);
     const Node *const node = space->node;
@@ -219,104 +304,95 @@ static void ApplyCollision(Space *space)
     const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const IntVec no = {part->no[X], part->no[Y], part->no[Z]};
     const Real zero = 0.0;
-    const Real one = 1.0;
     const int coltag = INT_MAX / 2; /* colliding polyhedron marker */
-    const Real crList[5] = {0.0, 0.25, 0.5, 0.75, 1.0}; /* coefficient of restitution */
     Polyhedron *polp = NULL;
     Polyhedron *poln = NULL;
     Collision *col = NULL;
     int idx = 0; /* linear array index math variable */
     int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
-    RealVec Vo = {zero}; /* original translational velocity */
-    RealVec Wo = {zero}; /* original rotational velocity */
     RealVec V = {zero}; /* relative translational velocity */
-    RealVec W = {zero}; /* relative rotational velocity */
     RealVec N = {zero}; /* line of impact */
-    Real Vn = zero; /* translational velocity projection on line of impact */
-    Real cr = zero; /* coefficient of restitution */
-    Real cf = zero; /* coefficient of sliding friction */
-    Real mp = zero; /* mass */
-    Real mn = zero; /* mass */
-    Real meff = zero; /* effective mass */
+    Real dist = zero; /* distance of centroids */
+    if (0 == geo->totN) {
+        return;
+    }
+    int *cand = AssignStorage(geo->totN * sizeof(*cand)); /* number of candidates */
+    Real (*cbox)[DIMS][LIMIT] = AssignStorage(geo->totN * sizeof(*cbox)); /* contact range */
+    DetectColCandidate(dt, part, geo, cand, cbox);
     for (int p = 0; p < geo->totN; ++p) {
         polp = geo->poly + p;
         if (1 == polp->state) { /* stationary object */
             continue;
         }
         geo->colN = 0; /* reset */
-        /* determine search range according to bounding box of polyhedron and valid node space */
+        /* skip polyhedron without any candidate, which is consistent for all processors */
+        if (0 == cand[p]) {
+            continue;
+        }
+        /* determine search range according to bounding box of polyhedron, contact range, and valid node space */
         for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(polp->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(polp->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+            box[s][MIN] = ConfineSpace(MapNode(MaxReal(polp->box[s][MIN], cbox[p][s][MIN]), sMin[s], dd[s], no[s]), nMin[s], nMax[s]);
+            box[s][MAX] = ConfineSpace(MapNode(MinReal(polp->box[s][MAX], cbox[p][s][MAX]), sMin[s], dd[s], no[s]), nMin[s], nMax[s]) + 1;
         }
         for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
             for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
                 for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].lid) || (p + 1 != node[idx].did)) {
+                    if ((1 != node->lid[idx]) || (p + 1 != node->did[idx])) {
                         continue;
                     }
                     DetectColState(k, j, i, p + 1, part->pathSep[1], part->path, node, part, geo);
                 }
             }
         }
-        /* skip none contacting polyhedron */
-        if (0 == geo->colN) {
-            continue;
-        }
-        /* backup original velocity */
-        memcpy(Vo, polp->V[TO], DIMS * sizeof(*polp->V[TO]));
-        memcpy(Wo, polp->W[TO], DIMS * sizeof(*polp->W[TO]));
-        /* initialize post-collision velocity */
-        memcpy(polp->V[TO], polp->V[TN], DIMS * sizeof(*polp->V[TO]));
-        memcpy(polp->W[TO], polp->W[TN], DIMS * sizeof(*polp->W[TO]));
+        /* merge colliding objects detected by all processors */
+        ReduceCollision(geo);
         /* pairwise collision */
-        mp = polp->rho * polp->volume;
         for (int n = 0; n < geo->colN; ++n) {
             col = geo->col + n;
+            poln = geo->poly + col->gid - 1;
+            if ((0 >= polp->faceN) && (0 >= poln->faceN)) { /* exact contact applies */
+                continue;
+            }
             /* line of impact */
             if (0 == abs(col->N[X]) + abs(col->N[Y]) + abs(col->N[Z])) {
-                if ((geo->colN - 1 == n) && (coltag > polp->state)) {
-                    /* recover contacting but none colliding polyhedron */
-                    memcpy(polp->V[TO], Vo, DIMS * sizeof(*polp->V[TO]));
-                    memcpy(polp->W[TO], Wo, DIMS * sizeof(*polp->W[TO]));
-                }
                 continue;
             }
             N[X] = col->N[X];
             N[Y] = col->N[Y];
             N[Z] = col->N[Z];
             Normalize(DIMS, Norm(N), N);
-            poln = geo->poly + col->gid - 1;
-            /* relative speed */
-            for (int s = 0; s < DIMS; ++s) {
-                V[s] = polp->V[TN][s] - poln->V[TN][s];
-                W[s] = polp->W[TN][s] - poln->W[TN][s];
-            }
-            Vn = Dot(V, N);
-            if (zero >= Vn) {
-                if ((geo->colN - 1 == n) && (coltag > polp->state)) {
-                    /* recover contacting but none colliding polyhedron */
-                    memcpy(polp->V[TO], Vo, DIMS * sizeof(*polp->V[TO]));
-                    memcpy(polp->W[TO], Wo, DIMS * sizeof(*polp->W[TO]));
-                }
-                continue;
-            }
-            /* mark colliding polyhedron */
-            if (coltag > polp->state) {
-                polp->state = polp->state + coltag;
-            }
-            mn = poln->rho * poln->volume;
-            meff = mn / (mp + mn);
-            cr = 0.5 * (crList[polp->mid] + crList[poln->mid]);
-            cf = 0.5 * (polp->cf + poln->cf);
-            /* vector summation of the velocity changes in the global frame */
-            for (int s = 0; s < DIMS; ++s) {
-                polp->V[TO][s] = polp->V[TO][s] - meff * (one + cr) * Vn * N[s] - cf * (V[s] - Vn * N[s]);
-                polp->W[TO][s] = polp->W[TO][s] - meff * W[s];
-            }
+            ApplyImpact(N, poln, coltag, polp);
+        }
+    }
+    /* exact contact of analytical polyhedrons by their spheres */
+    for (int n = 0; n < geo->pairN; ++n) {
+        polp = geo->poly + geo->pair[n][0];
+        poln = geo->poly + geo->pair[n][1];
+        if ((0 < polp->faceN) || (0 < poln->faceN)) {
+            continue;
+        }
+        for (int s = 0; s < DIMS; ++s) {
+            N[s] = poln->O[s] - polp->O[s];
+            V[s] = polp->V[TN][s] - poln->V[TN][s];
+        }
+        if (zero >= Dot(V, N)) { /* not approaching */
+            continue;
+        }
+        dist = Norm(N);
+        Normalize(DIMS, dist, N);
+        /* not contacting within the step */
+        if (dist - polp->r - poln->r > Dot(V, N) * dt) {
+            continue;
+        }
+        if (1 != polp->state) {
+            ApplyImpact(N, poln, coltag, polp);
+        }
+        Normalize(DIMS, -1.0, N);
+        if (1 != poln->state) {
+            ApplyImpact(N, polp, coltag, poln);
         }
     }
     /* update post-collision velocity for collided polyhedron */
@@ -329,8 +405,291 @@ static void ApplyCollision(Space *space)
         memcpy(polp->V[TN], polp->V[TO], DIMS * sizeof(*polp->V[TO]));
         memcpy(polp->W[TN], polp->W[TO], DIMS * sizeof(*polp->W[TO]));
     }
+    RetrieveStorage(cand);
+    RetrieveStorage(cbox);
     return;
 }
+/*
+ * Apply the velocity change of a polyhedron colliding with another one
+ * along the line of impact. Velocity changes are summed up in the global
+ * frame upon the pre-collision velocity, which is held at the averaged
+ * velocity until all collisions are resolved.
+ */
+static void ApplyImpact(const Real N[restrict], const Polyhedron *poln, const int coltag, Polyhedron *polp)
+{
+    const Real zero = 0.0;
+    const Real one = 1.0;
+    const Real crList[5] = {0.0, 0.25, 0.5, 0.75, 1.0}; /* coefficient of restitution */
+    RealVec V = {zero}; /* relative translational velocity */
+    RealVec W = {zero}; /* relative rotational velocity */
+    /* relative speed */
+    for (int s = 0; s < DIMS; ++s) {
+        V[s] = polp->V[TN][s] - poln->V[TN][s];
+        W[s] = polp->W[TN][s] - poln->W[TN][s];
+    }
+    const Real Vn = Dot(V, N); /* translational velocity projection on line of impact */
+    if (zero >= Vn) { /* contacting but none colliding */
+        return;
+    }
+    /* mark colliding polyhedron and initialize post-collision velocity */
+    if (coltag > polp->state) {
+        polp->state = polp->state + coltag;
+        memcpy(polp->V[TO], polp->V[TN], DIMS * sizeof(*polp->V[TO]));
+        memcpy(polp->W[TO], polp->W[TN], DIMS * sizeof(*polp->W[TO]));
+    }
+    const Real mp = polp->rho * polp->volume;
+    const Real mn = poln->rho * poln->volume;
+    const Real meff = mn / (mp + mn); /* effective mass */
+    const Real cr = 0.5 * (crList[polp->mid] + crList[poln->mid]); /* coefficient of restitution */
+    const Real cf = 0.5 * (polp->cf + poln->cf); /* coefficient of sliding friction */
+    /* vector summation of the velocity changes in the global frame */
+    for (int s = 0; s < DIMS; ++s) {
+        polp->V[TO][s] = polp->V[TO][s] - meff * (one + cr) * Vn * N[s] - cf * (V[s] - Vn * N[s]);
+        polp->W[TO][s] = polp->W[TO][s] - meff * W[s];
+    }
+    return;
+}
+/*
+ * Broad phase of collision detection.
+ *
+ * A node of a polyhedron can only detect another polyhedron when a node on
+ * its first layer searching path belongs to the other one. Hence, their
+ * bounding boxes are apart less than the path reach, and polyhedrons
+ * further apart never collide. Only pairs within a margin of one more
+ * cell than the path reach are candidates. Analytical polyhedrons collide
+ * exactly by their spheres, which only come into contact within the step
+ * when apart less than their displacement. Such pairs are kept in the
+ * neighbour list.
+ *
+ * For each polyhedron, the number of candidates to the node-level detection
+ * is counted, and the union of the bounding boxes of candidates enlarged
+ * by the margin gives the contact range, out of which the node-level
+ * detection finds nothing. Pairs of analytical polyhedrons are left to the
+ * exact contact of spheres.
+ */
+static void DetectColCandidate(const Real dt, const Partition *const part, Geometry *const geo,
+        int cand[restrict], Real cbox[restrict][DIMS][LIMIT])
+{
+    const int end = part->pathSep[1];
+    const Polyhedron *poly = NULL;
+    RealVec m = {0.0}; /* margin */
+    RealVec ml = {0.0}; /* margin of neighbour list */
+    Real disp = 0.0; /* max displacement of polyhedrons in the step */
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        if (1 == poly->state) { /* stationary object */
+            continue;
+        }
+        disp = MaxReal(disp, Norm(poly->V[TN]) * dt);
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        int reach = 0;
+        for (int n = 0; n < end; ++n) {
+            reach = MaxInt(reach, abs(part->path[n][s]));
+        }
+        m[s] = (reach + 1) * part->d[s];
+        if (0 < geo->stlN) { /* node-level detection applies */
+            ml[s] = m[s];
+        }
+    }
+    UpdateNeighbourList(ml, disp, part, geo);
+    for (int n = 0; n < geo->pairN; ++n) {
+        if ((0 >= geo->poly[geo->pair[n][0]].faceN) && (0 >= geo->poly[geo->pair[n][1]].faceN)) {
+            continue;
+        }
+        AddColCandidate(geo->poly + geo->pair[n][1], m, cand + geo->pair[n][0], cbox[geo->pair[n][0]]);
+        AddColCandidate(geo->poly + geo->pair[n][0], m, cand + geo->pair[n][1], cbox[geo->pair[n][1]]);
+    }
+    return;
+}
+static void AddColCandidate(const Polyhedron *poly, const Real m[restrict], int *cand,
+        Real cbox[restrict][LIMIT])
+{
+    /* the candidate box enlarged by the margin */
+    for (int s = 0; s < DIMS; ++s) {
+        if (0 == *cand) {
+            cbox[s][MIN] = poly->box[s][MIN] - m[s];
+            cbox[s][MAX] = poly->box[s][MAX] + m[s];
+        } else {
+            cbox[s][MIN] = MinReal(cbox[s][MIN], poly->box[s][MIN] - m[s]);
+            cbox[s][MAX] = MaxReal(cbox[s][MAX], poly->box[s][MAX] + m[s]);
+        }
+    }
+    ++(*cand);
+    return;
+}
+/*
+ * List pairs of polyhedrons apart less than a margin.
+ *
+ * Bounding boxes are enlarged at the upper side by the margin m in each
+ * direction. Boxes no larger than twice the mean size are binned by their
+ * lower corners into a uniform grid of cells no smaller than any of them,
+ * thus overlapping boxes are binned in the same or adjacent cells, and
+ * each box is only tested with later boxes in its cell and in half of the
+ * neighbouring cells. Larger boxes are tested with all the others. A pair
+ * is listed if the enlarged boxes overlap. Pairs of two stationary
+ * polyhedrons are ignored, and pairs of analytical polyhedrons are further
+ * tested exactly by their bounding spheres apart less than the margin mr.
+ *
+ * The pairs are held in the broad phase workspace, whose storage only
+ * grows and is kept across calls. Return the number of pairs.
+ */
+static int ListPairs(const Real m[restrict], const Real mr, Geometry *const geo)
+{
+    const Real zero = 0.0;
+    const int shell[14][DIMS] = { /* the cell and half of its neighbours */
+        {0, 0, 0}, {1, 0, 0}, {-1, 1, 0}, {0, 1, 0}, {1, 1, 0}, {-1, -1, 1}, {0, -1, 1},
+        {1, -1, 1}, {-1, 0, 1}, {0, 0, 1}, {1, 0, 1}, {-1, 1, 1}, {0, 1, 1}, {1, 1, 1}};
+    const Polyhedron *pa = NULL;
+    const Polyhedron *pb = NULL;
+    Binning *const bin = &(geo->bin);
+    RealVec lo = {zero}; /* lower bound of grid */
+    RealVec hi = {zero}; /* upper bound of grid */
+    RealVec size = {zero}; /* mean size of enlarged boxes */
+    RealVec cs = {zero}; /* cell size */
+    RealVec dd = {zero}; /* reciprocal of cell size */
+    IntVec nc = {1, 1, 1}; /* number of cells */
+    IntVec ic = {0}; /* cell of the lower corner */
+    int a = 0, b = 0; /* polyhedron index */
+    int c = 0; /* cell index */
+    int start = 0, end = 0; /* range of tested boxes in binned list */
+    int flag = 0; /* control flag */
+    int pairN = 0; /* number of pairs */
+    if (NULL == bin->eb) {
+        bin->eb = AssignStorage((geo->totN + 1) * sizeof(*bin->eb));
+        bin->cell = AssignStorage((geo->totN + 1) * sizeof(*bin->cell));
+        bin->list = AssignStorage((geo->totN + 1) * sizeof(*bin->list));
+    }
+    Real (*eb)[DIMS][LIMIT] = bin->eb;
+    int *cell = bin->cell;
+    int *list = bin->list;
+    /* enlarged bounding boxes, grid range, and mean box size */
+    for (int n = 0; n < geo->totN; ++n) {
+        for (int s = 0; s < DIMS; ++s) {
+            eb[n][s][MIN] = geo->poly[n].box[s][MIN];
+            eb[n][s][MAX] = geo->poly[n].box[s][MAX] + m[s];
+            lo[s] = (0 == n) ? eb[n][s][MIN] : MinReal(lo[s], eb[n][s][MIN]);
+            hi[s] = (0 == n) ? eb[n][s][MAX] : MaxReal(hi[s], eb[n][s][MAX]);
+            size[s] = size[s] + (eb[n][s][MAX] - eb[n][s][MIN]) / geo->totN;
+        }
+    }
+    /* cell size fitting boxes no larger than twice the mean size */
+    for (int n = 0; n < geo->totN; ++n) {
+        flag = 1;
+        for (int s = 0; s < DIMS; ++s) {
+            if (eb[n][s][MAX] - eb[n][s][MIN] > 2.0 * size[s]) {
+                flag = 0;
+            }
+        }
+        cell[n] = flag; /* mark binned boxes */
+        for (int s = 0; (1 == flag) && (s < DIMS); ++s) {
+            cs[s] = MaxReal(cs[s], eb[n][s][MAX] - eb[n][s][MIN]);
+        }
+    }
+    /* number of cells, limited to a few per polyhedron */
+    for (int s = 0; s < DIMS; ++s) {
+        if (zero < cs[s]) {
+            nc[s] = MaxInt(1, (int)(MinReal(hi[s] - lo[s], geo->totN * cs[s]) / cs[s]));
+        }
+    }
+    while ((Real)nc[X] * nc[Y] * nc[Z] > 4.0 * geo->totN) {
+        for (int s = 0; s < DIMS; ++s) {
+            nc[s] = (nc[s] + 1) / 2;
+        }
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        if (zero < hi[s] - lo[s]) {
+            dd[s] = nc[s] / (hi[s] - lo[s]);
+        }
+    }
+    /* bin polyhedrons into cells by counting sort, larger ones into an extra cell */
+    const int cellN = nc[X] * nc[Y] * nc[Z];
+    if (cellN + 2 > bin->cellM) {
+        RetrieveStorage(bin->head);
+        RetrieveStorage(bin->top);
+        bin->cellM = cellN + 2;
+        bin->head = AssignStorage(bin->cellM * sizeof(*bin->head));
+        bin->top = AssignStorage(bin->cellM * sizeof(*bin->top));
+    }
+    int *head = bin->head; /* start of each cell in binned list */
+    int *top = bin->top; /* filled number of each cell */
+    memset(head, 0, (cellN + 2) * sizeof(*head));
+    memset(top, 0, (cellN + 1) * sizeof(*top));
+    for (int n = 0; n < geo->totN; ++n) {
+        if (0 == cell[n]) {
+            cell[n] = cellN;
+        } else {
+            for (int s = 0; s < DIMS; ++s) {
+                ic[s] = ConfineSpace((int)((eb[n][s][MIN] - lo[s]) * dd[s]), 0, nc[s]);
+            }
+            cell[n] = IndexNode(ic[Z], ic[Y], ic[X], nc[Y], nc[X]);
+        }
+        ++head[cell[n] + 1];
+    }
+    for (c = 0; c <= cellN; ++c) {
+        head[c + 1] = head[c + 1] + head[c];
+    }
+    for (int n = 0; n < geo->totN; ++n) {
+        list[head[cell[n]] + top[cell[n]]] = n;
+        ++top[cell[n]];
+    }
+    /* test each binned box with later ones in its cell and in half of its
+     * neighbouring cells, and each larger box with all the others */
+    for (int u = 0; u < geo->totN; ++u) {
+        a = list[u];
+        pa = geo->poly + a;
+        for (int n = 0; n < 14; ++n) {
+            if (cellN == cell[a]) {
+                if (1 < n) {
+                    break;
+                }
+                start = (0 == n) ? 0 : u + 1;
+                end = (0 == n) ? head[cellN] : geo->totN;
+            } else {
+                ic[X] = cell[a] % nc[X] + shell[n][X];
+                ic[Y] = (cell[a] / nc[X]) % nc[Y] + shell[n][Y];
+                ic[Z] = cell[a] / (nc[X] * nc[Y]) + shell[n][Z];
+                if ((0 > ic[X]) || (nc[X] <= ic[X]) || (0 > ic[Y]) || (nc[Y] <= ic[Y]) || (nc[Z] <= ic[Z])) {
+                    continue;
+                }
+                c = IndexNode(ic[Z], ic[Y], ic[X], nc[Y], nc[X]);
+                start = (0 == n) ? u + 1 : head[c];
+                end = head[c + 1];
+            }
+            for (int w = start; w < end; ++w) {
+                b = list[w];
+                pb = geo->poly + b;
+                flag = 1;
+                for (int s = 0; s < DIMS; ++s) {
+                    if ((eb[b][s][MIN] > eb[a][s][MAX]) || (eb[a][s][MIN] > eb[b][s][MAX])) {
+                        flag = 0;
+                        break;
+                    }
+                }
+                if ((0 == flag) || ((1 == pa->state) && (1 == pb->state))) {
+                    continue;
+                }
+                if ((0 >= pa->faceN) && (0 >= pb->faceN) &&
+                        (Dist2(pa->O, pb->O) > (pa->r + pb->r + mr) * (pa->r + pb->r + mr))) {
+                    continue; /* sphere-sphere test */
+                }
+                if (pairN + 1 >= bin->pairM) { /* grow the pair list */
+                    int (*pair)[2] = AssignStorage(2 * (bin->pairM + geo->totN) * sizeof(*pair));
+                    if (0 < pairN) {
+                        memcpy(pair, bin->pair, pairN * sizeof(*pair));
+                    }
+                    RetrieveStorage(bin->pair);
+                    bin->pair = pair;
+                    bin->pairM = 2 * (bin->pairM + geo->totN);
+                }
+                bin->pair[pairN][0] = a;
+                bin->pair[pairN][1] = b;
+                ++pairN;
+            }
+        }
+    }
+    return pairN;
+}
 static void DetectColState(const int k, const int j, const int i, const int did,
         const int end, const int path[restrict][DIMS], const Node *const node,
         const Partition *const part, Geometry *const geo)
@@ -338,24 +697,26 @@ static void DetectColState(const int k, const int j, const int i, const int did,
     /* search around the specified node to find colliding objects */
     int idx = 0; /* linear array index math variable */
     int ih = 0, jh = 0, kh = 0; /* neighbouring node */
+    const IntVec key = {i - part->no[X], j - part->no[Y], k - part->no[Z]}; /* global node */
     for (int n = 0; n < end; ++n) {
         kh = k + path[n][Z];
         jh = j + path[n][Y];
         ih = i + path[n][X];
-        if (!InPartBox(kh, jh, ih, part->ns[PIN])) {
+        if (!InPartBox(kh, jh, ih, part->ns[PEX])) {
             continue;
         }
         idx = IndexNode(kh, jh, ih, part->n[Y], part->n[X]);
-        if (0 == node[idx].did) { /* a fluid node is not valid */
+        if (0 == node->did[idx]) { /* a fluid node is not valid */
             continue;
         }
-        if (did != node[idx].did) { /* a heterogeneous node on the path */
-            AddColObject(path[n], node[idx].did, geo);
+        if (did != node->did[idx]) { /* a heterogeneous node on the path */
+            AddColObject(path[n], key, node->did[idx], geo);
         }
     }
     return;
 }
-static void AddColObject(const int N[restrict], const int did, Geometry *const geo)
+static void AddColObject(const int N[restrict], const int key[restrict], const int did,
+        Geometry *const geo)
 {
     Collision *col = NULL;
     /* search the object list, if already exist, adjust the line of impact */
@@ -374,6 +735,9 @@ static void AddColObject(const int N[restrict], const int did, Geometry *const g
     col->N[X] = N[X];
     col->N[Y] = N[Y];
     col->N[Z] = N[Z];
+    col->key[X] = key[X];
+    col->key[Y] = key[Y];
+    col->key[Z] = key[Z];
     ++(geo->colN);
     return;
 }
@@ -383,7 +747,6 @@ static void ApplyMotion(const Real dt, Space *space)
     Polyhedron *poly = NULL;
     RealVec offset = {0.0}; /* translation */
     RealVec angle = {0.0}; /* rotation */
-    const RealVec scale = {1.0, 1.0, 1.0}; /* scale */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         if (1 == poly->state) { /* stationary object */
@@ -394,21 +757,256 @@ static void ApplyMotion(const Real dt, Space *space)
             offset[s] = poly->V[TN][s] * dt;
             angle[s] = poly->W[TN][s] * dt;
         }
-        /* transform geometry */
-        if (0 >= poly->faceN) { /* analytical polyhedron */
-            poly->O[X] = poly->O[X] + offset[X];
-            poly->O[Y] = poly->O[Y] + offset[Y];
-            poly->O[Z] = poly->O[Z] + offset[Z];
-            /* bounding box */
+        DisplacePolyhedron(offset, angle, poly);
+        geo->drift[n] = geo->drift[n] + Norm(offset) + poly->r * Norm(angle);
+    }
+    return;
+}
+static void DisplacePolyhedron(const Real offset[restrict], const Real angle[restrict], Polyhedron *poly)
+{
+    if (0 >= poly->faceN) { /* analytical polyhedron */
+        poly->O[X] = poly->O[X] + offset[X];
+        poly->O[Y] = poly->O[Y] + offset[Y];
+        poly->O[Z] = poly->O[Z] + offset[Z];
+        /* bounding box */
+        for (int s = 0; s < DIMS; ++s) {
+            poly->box[s][MIN] = poly->O[s] - poly->r;
+            poly->box[s][MAX] = poly->O[s] + poly->r;
+        }
+    } else { /* triangulated polyhedron, update the pose only */
+        MovePolyhedron(offset, angle, poly);
+    }
+    return;
+}
+/*
+ * Soft-sphere contact dynamics.
+ *
+ * Contacting polyhedrons interact by a linear spring-dashpot normal force
+ * and a tangential force limited by sliding friction. The normal damping
+ * recovers the coefficient of restitution of the pair. Surface force and
+ * body force are held during the step, while contact force and motion are
+ * sub-cycled with a sub-step resolving the contact duration of the
+ * lightest moving polyhedron.
+ *
+ * Contact force is only evaluated for pairs in the neighbour list. Two
+ * analytical polyhedrons contact by their spheres, and an analytical
+ * polyhedron contacts a triangulated one at the closest surface point.
+ * Two triangulated polyhedrons do not contact.
+ */
+static void ApplyContact(const Real now, const Real dt, const Partition *const part, Geometry *const geo,
+        const Model *model)
+{
+    const Real zero = 0.0;
+    const Real one = 1.0;
+    const Real crList[5] = {0.0, 0.25, 0.5, 0.75, 1.0}; /* coefficient of restitution */
+    const int subN = 50; /* sub-steps per contact duration */
+    const RealVec m = {zero}; /* contact margin */
+    Polyhedron *pa = NULL;
+    Polyhedron *pb = NULL;
+    Polyhedron *poly = NULL;
+    Real A[DIMS][DIMS] = {{zero}};
+    Real B[DIMS][1] = {{zero}};
+    Real Ac[DIMS][1] = {{zero}}; /* rotational acceleration from contact torque */
+    RealVec N = {zero}; /* line of impact from a to b */
+    RealVec ra = {zero}; /* contact point relative to centroid of a */
+    RealVec rb = {zero}; /* contact point relative to centroid of b */
+    RealVec Va = {zero}; /* velocity of contact point on a */
+    RealVec Vb = {zero}; /* velocity of contact point on b */
+    RealVec Vt = {zero}; /* tangential relative velocity */
+    RealVec F = {zero}; /* contact force on a */
+    RealVec T = {zero}; /* contact torque */
+    RealVec offset = {zero}; /* translation */
+    RealVec angle = {zero}; /* rotation */
+    Real delta = zero; /* overlap */
+    Real Vn = zero; /* relative velocity projection on line of impact */
+    Real Fn = zero; /* normal force */
+    Real Ft = zero; /* tangential force */
+    Real cr = zero; /* coefficient of restitution */
+    Real cf = zero; /* coefficient of sliding friction */
+    Real beta = zero; /* damping ratio */
+    Real meff = zero; /* effective mass */
+    Real mMin = zero; /* minimum mass of moving polyhedrons */
+    Real disp = zero; /* max displacement of polyhedrons in a sub-step */
+    int a = 0, b = 0; /* polyhedron index */
+    /* acceleration from surface force and body force held during the step */
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        if (1 == poly->state) { /* stationary object */
+            continue;
+        }
+        ComputeAcceleration(now, poly);
+        mMin = (zero == mMin) ? poly->rho * poly->volume : MinReal(mMin, poly->rho * poly->volume);
+        disp = MaxReal(disp, Norm(poly->V[TO]) + poly->r * Norm(poly->W[TO]));
+        memset(poly->V[TN], 0, DIMS * sizeof(*poly->V[TN]));
+        memset(poly->W[TN], 0, DIMS * sizeof(*poly->W[TN]));
+    }
+    if (zero == mMin) {
+        return;
+    }
+    const int stepN = MaxInt(1, (int)ceil(dt * subN / (PI * sqrt(0.5 * mMin / model->kn))));
+    const Real h = dt / stepN;
+    disp = disp * h; /* the first sub-step is estimated by current speeds */
+    Real (*Fc)[DIMS] = AssignStorage(geo->totN * sizeof(*Fc)); /* contact force */
+    Real (*Tc)[DIMS] = AssignStorage(geo->totN * sizeof(*Tc)); /* contact torque */
+    for (int step = 0; step < stepN; ++step) {
+        UpdateNeighbourList(m, disp, part, geo);
+        disp = zero;
+        memset(Fc, 0, geo->totN * sizeof(*Fc));
+        memset(Tc, 0, geo->totN * sizeof(*Tc));
+        for (int n = 0; n < geo->pairN; ++n) {
+            a = geo->pair[n][0];
+            b = geo->pair[n][1];
+            pa = geo->poly + a;
+            pb = geo->poly + b;
+            if (!ComputeContactGeometry(pa, pb, N, ra, rb, &delta)) {
+                continue;
+            }
+            /* relative velocity at contact point */
+            Cross(pa->W[TO], ra, Va);
+            Cross(pb->W[TO], rb, Vb);
+            for (int s = 0; s < DIMS; ++s) {
+                Vt[s] = (pa->V[TO][s] + Va[s]) - (pb->V[TO][s] + Vb[s]);
+            }
+            Vn = Dot(Vt, N);
+            for (int s = 0; s < DIMS; ++s) {
+                Vt[s] = Vt[s] - Vn * N[s];
+            }
+            /* effective mass, stationary polyhedrons have infinite mass */
+            meff = ((1 == pa->state) ? zero : one / (pa->rho * pa->volume)) +
+                ((1 == pb->state) ? zero : one / (pb->rho * pb->volume));
+            meff = one / meff;
+            /* spring-dashpot normal force with damping from restitution */
+            cr = 0.5 * (crList[pa->mid] + crList[pb->mid]);
+            cf = 0.5 * (pa->cf + pb->cf);
+            beta = one;
+            if (zero < cr) {
+                beta = -log(cr) / sqrt(log(cr) * log(cr) + PI * PI);
+            }
+            /* the damping is kept while overlapping, even pulling at the end of
+             * the contact, as cutting it off would raise the restitution */
+            Fn = model->kn * delta + 2.0 * beta * sqrt(meff * model->kn) * Vn;
+            /* sliding friction limited by stopping sliding in a sub-step */
+            Ft = MinReal(cf * MaxReal(zero, Fn), meff * Norm(Vt) / h);
+            if (zero < Ft) {
+                Normalize(DIMS, Norm(Vt), Vt);
+            }
+            for (int s = 0; s < DIMS; ++s) {
+                F[s] = -Fn * N[s] - Ft * Vt[s];
+                Fc[a][s] = Fc[a][s] + F[s];
+                Fc[b][s] = Fc[b][s] - F[s];
+            }
+            Cross(ra, F, T);
+            for (int s = 0; s < DIMS; ++s) {
+                Tc[a][s] = Tc[a][s] + T[s];
+            }
+            Cross(F, rb, T);
             for (int s = 0; s < DIMS; ++s) {
-                poly->box[s][MIN] = poly->O[s] - poly->r;
-                poly->box[s][MAX] = poly->O[s] + poly->r;
+                Tc[b][s] = Tc[b][s] + T[s];
             }
-        } else { /* triangulated polyhedron */
-            TransformPolyhedron(poly->O, scale, angle, offset, poly);
         }
+        /* velocity and position integration */
+        for (int n = 0; n < geo->totN; ++n) {
+            poly = geo->poly + n;
+            if (1 == poly->state) { /* stationary object */
+                continue;
+            }
+            for (int s = 0; s < DIMS; ++s) {
+                for (int m = 0; m < DIMS; ++m) {
+                    A[s][m] = poly->I[s][m];
+                }
+                B[s][0] = Tc[n][s] / poly->rho;
+            }
+            SolveLinearSystem(DIMS, A, 1, B, Ac);
+            for (int s = 0; s < DIMS; ++s) {
+                poly->V[TO][s] = poly->V[TO][s] + (poly->at[TO][s] + Fc[n][s] / (poly->rho * poly->volume)) * h;
+                poly->W[TO][s] = poly->W[TO][s] + (poly->ar[TO][s] + Ac[s][0]) * h;
+                offset[s] = poly->V[TO][s] * h;
+                angle[s] = poly->W[TO][s] * h;
+                /* averaged velocity during the step */
+                poly->V[TN][s] = poly->V[TN][s] + poly->V[TO][s] / stepN;
+                poly->W[TN][s] = poly->W[TN][s] + poly->W[TO][s] / stepN;
+            }
+            DisplacePolyhedron(offset, angle, poly);
+            geo->drift[n] = geo->drift[n] + Norm(offset) + poly->r * Norm(angle);
+            disp = MaxReal(disp, Norm(offset) + poly->r * Norm(angle));
+        }
+    }
+    RetrieveStorage(Fc);
+    RetrieveStorage(Tc);
+    return;
+}
+/*
+ * The neighbour list holds pairs apart less than the margin plus a skin
+ * distance. It is rebuilt once a polyhedron would drift over half of the
+ * skin distance by the coming displacement, before which pairs out of the
+ * list are still apart more than the margin after the displacement. The
+ * skin is SKINN of the largest cell size.
+ */
+static void UpdateNeighbourList(const Real m[restrict], const Real disp, const Partition *const part,
+        Geometry *const geo)
+{
+    const Real skin = SKINN * MaxReal(part->d[X], MaxReal(part->d[Y], part->d[Z])); /* neighbour list skin */
+    Real drift = 0.0; /* max drift */
+    for (int n = 0; n < geo->totN; ++n) {
+        drift = MaxReal(drift, geo->drift[n]);
     }
+    if ((NULL != geo->pair) && (0.5 * skin > drift + disp)) {
+        return;
+    }
+    const RealVec ms = {m[X] + skin, m[Y] + skin, m[Z] + skin};
+    geo->pairN = ListPairs(ms, Norm(m) + skin, geo);
+    RetrieveStorage(geo->pair);
+    geo->pair = AssignStorage((geo->pairN + 1) * sizeof(*geo->pair));
+    memcpy(geo->pair, geo->bin.pair, geo->pairN * sizeof(*geo->pair));
+    memset(geo->drift, 0, geo->totN * sizeof(*geo->drift));
     return;
 }
+/*
+ * Find the overlap, the line of impact from a to b, and the contact point
+ * relative to the centroid of each polyhedron. Return 0 if not contacting.
+ */
+static int ComputeContactGeometry(const Polyhedron *pa, const Polyhedron *pb, Real N[restrict],
+        Real ra[restrict], Real rb[restrict], Real *delta)
+{
+    const Real zero = 0.0;
+    RealVec pi = {zero}; /* closest surface point */
+    int fid = 0; /* closest face */
+    if ((0 < pa->faceN) && (0 < pb->faceN)) { /* two triangulated polyhedrons */
+        return 0;
+    }
+    if (0 < pa->faceN) { /* swap to place the analytical polyhedron first */
+        if (!ComputeContactGeometry(pb, pa, N, rb, ra, delta)) {
+            return 0;
+        }
+        Normalize(DIMS, -1.0, N);
+        return 1;
+    }
+    if (0 >= pb->faceN) { /* two analytical polyhedrons */
+        const Real dist = Dist(pa->O, pb->O);
+        *delta = pa->r + pb->r - dist;
+        if ((zero >= *delta) || (zero >= dist)) {
+            return 0;
+        }
+        for (int s = 0; s < DIMS; ++s) {
+            N[s] = (pb->O[s] - pa->O[s]) / dist;
+            ra[s] = pa->r * N[s];
+            rb[s] = -pb->r * N[s];
+        }
+        return 1;
+    }
+    /* analytical and triangulated polyhedron, outward normal points to the sphere center */
+    const int inside = PointInPolyhedron(pa->O, pb, &fid);
+    const Real dist = sqrt(ComputeIntersection(pa->O, fid, pb, pi, N));
+    *delta = (inside) ? pa->r + dist : pa->r - dist;
+    if ((zero >= *delta) || (zero >= Norm(N))) {
+        return 0;
+    }
+    Normalize(DIMS, -Norm(N), N);
+    for (int s = 0; s < DIMS; ++s) {
+        ra[s] = pa->r * N[s];
+        rb[s] = pi[s] - pb->O[s];
+    }
+    return 1;
+}
 /* a good practice: end file with a newline */
 
@@ -19,6 +19,9 @@
 #include "fluid_dynamics.h"
 #include "solid_dynamics.h"
 #include "data_stream.h"
+#include "data_probe.h"
+#include "statistics.h"
+#include "data_exchange.h"
 #include "timer.h"
 #include "cfd_commons.h"
 #include "commons.h"
@@ -39,9 +42,12 @@ int Solve(Time *time, Space *space, const Model *model)
 {
     ShowInfo("Solving...\n");
     ShowInfo("  initializing...\n");
+    InitializeDataStream();
     InitializeComputeDomain(time, space, model);
     ShowInfo("  time marching...\n");
     EvolveSolution(time, space, model);
+    FinalizeProbeData();
+    FinalizeDataStream();
     ShowInfo("Session");
     return 0;
 }
@@ -54,22 +60,21 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
         return;
     }
     Timer tm; /* timer for computing operations */
-    /* data writing interval and recorder */
+    /* data writing interval, the recorders are kept in time to be checkpointed */
     const Real dtData[NPROBE] = {time->end / (Real)(time->dataW[PROPT]),
         time->end / (Real)(time->dataW[PROLN]), time->end / (Real)(time->dataW[PROCV]),
-        time->end / (Real)(time->dataW[PROFC]), time->end / (Real)(time->dataW[PROSD])};
-    Real rcData[NPROBE] = {zero};
-    /* time instants interval and recorder */
+        time->end / (Real)(time->dataW[PROFC]), time->end / (Real)(time->dataW[PROSL]),
+        time->end / (Real)(time->dataW[PROSD])};
+    /* time instants interval */
     const Real tmInt = (INT_MAX == time->dataW[PROSD]) ? time->end : dtData[PROSD]; /* a specific instant */
-    Real rcInt = zero; /* time instant recorder */
     while ((time->now < time->end) && (time->stepC < time->stepN)) {
         ++(time->stepC);
         dt = ComputeTimeStep(time, space, model);
-        if (rcInt + dt > tmInt) { /* rectify dt */
-            dt = tmInt - rcInt;
-            rcInt = zero;
+        if (time->rcInt + dt > tmInt) { /* rectify dt */
+            dt = tmInt - time->rcInt;
+            time->rcInt = zero;
         } else {
-            rcInt = rcInt + dt;
+            time->rcInt = time->rcInt + dt;
         }
         time->now = time->now + dt;
         if (time->now > time->end) { /* rectify dt */
@@ -80,17 +85,18 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
                 time->stepC, time->now, time->end - time->now, dt);
         TickTime(&tm);
         if (0 != model->psi) {
-            EvolveSolidDynamics(time->now, 0.5 * dt, space, model);
+            EvolveSolidDynamics(time->now, dt, space, model);
         }
         EvolveFluidDynamics(dt, space, model);
-        if (0 != model->psi) {
-            EvolveSolidDynamics(time->now, 0.5 * dt, space, model);
+        if ((0 != time->statW) && (0 == time->stepC % time->statW)) {
+            AccumulateStatistics(time, space, model);
         }
         ShowInfo("  elapsed: %.6gs\n", TockTime(&tm));
         /* export data if accumulated time increases to anticipated interval */
         for (int n = 0; n < NPROBE; ++n) {
-            rcData[n] = rcData[n] + dt;
-            if ((rcData[n] >= dtData[n]) || (time->now == time->end) || (time->stepC == time->stepN)) {
+            time->rcData[n] = time->rcData[n] + dt;
+            if ((time->rcData[n] >= dtData[n]) || (time->now == time->end) || (time->stepC == time->stepN)) {
+                time->rcData[n] = zero; /* reset probe accumulated time */
                 if (PROFC == n) {
                     IntegrateSurfaceForce(space, model);
                 }
@@ -99,7 +105,6 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
                     ++(time->dataC); /* export count increase */
                 }
                 WriteData(n, time, space, model);
-                rcData[n] = zero; /* reset probe accumulated time */
             }
         }
     }
@@ -109,35 +114,21 @@ static Real ComputeTimeStep(const Time *time, const Space *space, const Model *m
 {
     const Partition *const part = &(space->part);
     const Node *const node = space->node;
-    const Geometry *const geo = &(space->geo);
-    const Polyhedron *poly = NULL;
-    const Real *restrict U = NULL;
+    Real U[DIMU] = {0.0};
     Real Uo[DIMUo] = {0.0};
     int idx = 0; /* linear array index math variable */
     Real c = 0.0; /* speed of sound */
     RealVec V = {0.0}; /* characteristic speeds in each direction */
     RealVec Vmax = {0.0}; /* maximum characteristic speeds in each direction */
-    /* incorporate solid dynamics into CFL condition */
-    for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
-        V[X] = fabs(poly->V[TO][X]) + MaxReal(fabs(poly->W[TO][Y]), fabs(poly->W[TO][Z])) * poly->r;
-        V[Y] = fabs(poly->V[TO][Y]) + MaxReal(fabs(poly->W[TO][Z]), fabs(poly->W[TO][X])) * poly->r;
-        V[Z] = fabs(poly->V[TO][Z]) + MaxReal(fabs(poly->W[TO][X]), fabs(poly->W[TO][Y])) * poly->r;
-        for (int s = 0; s < DIMS; ++s) {
-            if (Vmax[s] < V[s]) {
-                Vmax[s] = V[s];
-            }
-        }
-    }
-    /* incorporate fluid dynamics into CFL condition */
+    /* fluid dynamics determines the CFL condition, solid dynamics is sub-cycled */
     for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
         for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
             for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                U = node[idx].U[TO];
-                if (0 != node[idx].did) {
+                if (0 != node->did[idx]) {
                     continue;
                 }
+                LoadU(TO, idx, node, U);
                 MapPrimitive(model->gamma, model->gasR, U, Uo);
                 c = sqrt(model->gamma * model->gasR * Uo[5]);
                 for (int s = 0; s < DIMS; ++s) {
@@ -149,6 +140,8 @@ static Real ComputeTimeStep(const Time *time, const Space *space, const Model *m
             }
         }
     }
+    /* the fastest characteristic speeds over all processors */
+    ReduceMaxReal(DIMS, Vmax);
     return time->numCFL * MinReal(part->d[X] / Vmax[X], MinReal(part->d[Y] / Vmax[Y], part->d[Z] / Vmax[Z]));
 }
 /* a good practice: end file with a newline */
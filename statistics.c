@@ -0,0 +1,79 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "statistics.h"
+#include <math.h> /* common mathematical functions */
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Welford, B. P. (1962). Note on a method for calculating corrected sums
+ * of squares and products. Technometrics, 4(3), 419-420.
+ *
+ * The statistics of a node are stored contiguously, and the nodes are
+ * visited in storage order, so each sample streams through the field and
+ * the statistics once.
+ */
+void AccumulateStatistics(Time *time, Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    Node *const node = space->node;
+    ++(time->statC);
+    const Real r = 1.0 / (Real)(time->statC);
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+    for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
+        for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
+            int idx = 0; /* linear array index math variable */
+            Real U[DIMU] = {0.0};
+            Real Uo[DIMUo] = {0.0}; /* sample of rho, u, v, w, p, T */
+            Real d[DIMUo] = {0.0}; /* deviation from the previous means */
+            Real *restrict stat = NULL;
+            for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                stat = node->stat + (size_t)idx * DIMSTAT;
+                LoadU(TO, idx, node, U);
+                Uo[0] = U[0];
+                Uo[1] = U[1] / U[0];
+                Uo[2] = U[2] / U[0];
+                Uo[3] = U[3] / U[0];
+                Uo[4] = ComputePressure(model->gamma, U);
+                Uo[5] = ComputeTemperature(model->cv, U);
+                for (int n = 0; n < DIMUo; ++n) {
+                    d[n] = Uo[n] - stat[STMEAN + n];
+                    stat[STMEAN + n] = stat[STMEAN + n] + r * d[n];
+                    stat[STVAR + n] = stat[STVAR + n] + d[n] * (Uo[n] - stat[STMEAN + n]);
+                }
+                stat[STCOV + 0] = stat[STCOV + 0] + d[1] * (Uo[2] - stat[STMEAN + 2]);
+                stat[STCOV + 1] = stat[STCOV + 1] + d[1] * (Uo[3] - stat[STMEAN + 3]);
+                stat[STCOV + 2] = stat[STCOV + 2] + d[2] * (Uo[3] - stat[STMEAN + 3]);
+            }
+        }
+    }
+    return;
+}
+Real ComputeStatistic(const int s, const int sampleN, const Real stat[restrict])
+{
+    if (STVAR > s) {
+        return stat[s];
+    }
+    const Real r = 1.0 / (Real)((0 < sampleN) ? sampleN : 1);
+    if (STCOV > s) {
+        return sqrt(r * stat[s]);
+    }
+    return r * stat[s];
+}
+/* a good practice: end file with a newline */
@@ -0,0 +1,51 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_STATISTICS_H_ /* if undefined */
+#define ARTRACFD_STATISTICS_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    STMEAN = 0, /* means of rho, u, v, w, p, T */
+    STVAR = 6, /* second moments of rho, u, v, w, p, T about their means */
+    STCOV = 12, /* second moments of uv, uw, vw about their means */
+} StConst;
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Statistics accumulator
+ *
+ * Function
+ *      Add the current field as a sample to the running statistics of
+ *      each node by the Welford update, which is numerically stable for
+ *      long runs, and increase the sample count.
+ */
+extern void AccumulateStatistics(Time *, Space *, const Model *);
+/*
+ * Statistical variable
+ *
+ * Function
+ *      Return statistical variable s of a node from its running
+ *      statistics and the sample count: the means of rho, u, v, w, p, T
+ *      for s in [0, 5], their RMS fluctuations for s in [6, 11], and the
+ *      Reynolds shear stresses uv, uw, vw for s in [12, 14].
+ */
+extern Real ComputeStatistic(const int s, const int sampleN, const Real stat[restrict]);
+#endif
+/* a good practice: end file with a newline */
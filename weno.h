@@ -31,6 +31,15 @@
  */
 extern void WENO3(Real F[restrict][DIMU], Real Fhat[restrict]);
 extern void WENO5(Real F[restrict][DIMU], Real Fhat[restrict]);
+/*
+ * WENO for a batch of interfaces
+ *
+ * Function
+ *      Reconstruct the numerical convective flux of BATCHN interfaces.
+ *      Stencil data are stored with the interface as the fastest index.
+ */
+extern void WENO3Batch(Real F[restrict][DIMU][BATCHN], Real Fhat[restrict][BATCHN]);
+extern void WENO5Batch(Real F[restrict][DIMU][BATCHN], Real Fhat[restrict][BATCHN]);
 #endif
 /* a good practice: end file with a newline */
 
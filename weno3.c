@@ -53,6 +53,23 @@ void WENO3(Real F[restrict][DIMU], Real Fhat[restrict])
     }
     return;
 }
+void WENO3Batch(Real F[restrict][DIMU][BATCHN], Real Fhat[restrict][BATCHN])
+{
+    const Real C[R] = {1.0 / 3.0, 2.0 / 3.0};
+    const Real epsilon = 1.0e-6;
+    for (int r = 0; r < DIMU; ++r) {
+        for (int b = 0; b < BATCHN; ++b) {
+            const Real IS0 = Square(F[CN][r][b] - F[CN-1][r][b]);
+            const Real IS1 = Square(F[CN+1][r][b] - F[CN][r][b]);
+            const Real alpha0 = C[0] / Square(epsilon + IS0);
+            const Real alpha1 = C[1] / Square(epsilon + IS1);
+            const Real q0 = (1.0 / 2.0) * (-F[CN-1][r][b] + 3.0 * F[CN][r][b]);
+            const Real q1 = (1.0 / 2.0) * (F[CN][r][b] + F[CN+1][r][b]);
+            Fhat[r][b] = (alpha0 / (alpha0 + alpha1)) * q0 + (alpha1 / (alpha0 + alpha1)) * q1;
+        }
+    }
+    return;
+}
 static Real Square(const Real x)
 {
     return x * x;
@@ -60,6 +60,31 @@ void WENO5(Real F[restrict][DIMU], Real Fhat[restrict])
     }
     return;
 }
+void WENO5Batch(Real F[restrict][DIMU][BATCHN], Real Fhat[restrict][BATCHN])
+{
+    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
+    const Real epsilon = 1.0e-6;
+    for (int r = 0; r < DIMU; ++r) {
+        for (int b = 0; b < BATCHN; ++b) {
+            const Real IS0 = (13.0 / 12.0) * Square(F[CN-2][r][b] - 2.0 * F[CN-1][r][b] + F[CN][r][b]) +
+                (1.0 / 4.0) * Square(F[CN-2][r][b] - 4.0 * F[CN-1][r][b] + 3.0 * F[CN][r][b]);
+            const Real IS1 = (13.0 / 12.0) * Square(F[CN-1][r][b] - 2.0 * F[CN][r][b] + F[CN+1][r][b]) +
+                (1.0 / 4.0) * Square(F[CN-1][r][b] - F[CN+1][r][b]);
+            const Real IS2 = (13.0 / 12.0) * Square(F[CN][r][b] - 2.0 * F[CN+1][r][b] + F[CN+2][r][b]) +
+                (1.0 / 4.0) * Square(3.0 * F[CN][r][b] - 4.0 * F[CN+1][r][b] + F[CN+2][r][b]);
+            const Real alpha0 = C[0] / Square(epsilon + IS0);
+            const Real alpha1 = C[1] / Square(epsilon + IS1);
+            const Real alpha2 = C[2] / Square(epsilon + IS2);
+            const Real q0 = (1.0 / 6.0) * (2.0 * F[CN-2][r][b] - 7.0 * F[CN-1][r][b] + 11.0 * F[CN][r][b]);
+            const Real q1 = (1.0 / 6.0) * (-F[CN-1][r][b] + 5.0 * F[CN][r][b] + 2.0 * F[CN+1][r][b]);
+            const Real q2 = (1.0 / 6.0) * (2.0 * F[CN][r][b] + 5.0 * F[CN+1][r][b] - F[CN+2][r][b]);
+            Fhat[r][b] = (alpha0 / (alpha0 + alpha1 + alpha2)) * q0 +
+                (alpha1 / (alpha0 + alpha1 + alpha2)) * q1 +
+                (alpha2 / (alpha0 + alpha1 + alpha2)) * q2;
+        }
+    }
+    return;
+}
 static Real Square(const Real x)
 {
     return x * x;